@@ -7,6 +7,8 @@ CHECK_INCLUDE_FILE_CXX(ndir.h HAVE_NDIR_H)              # src/streams/strigi/stg
 CHECK_INCLUDE_FILE_CXX(stddef.h HAVE_STDDEF_H)          # unused !
 CHECK_INCLUDE_FILE_CXX(sys/dir.h HAVE_SYS_DIR_H)        # src/streams/strigi/stgdirent.cpp/.h
 CHECK_INCLUDE_FILE_CXX(sys/ndir.h HAVE_SYS_NDIR_H)      # src/streams/strigi/stgdirent.cpp/.h
+CHECK_INCLUDE_FILE_CXX(sys/inotify.h HAVE_SYS_INOTIFY_H) # lib/dirwatcher.cpp
+CHECK_INCLUDE_FILE_CXX(sys/mman.h HAVE_SYS_MMAN_H)      # lib/mmapinputstream.cpp
 CHECK_INCLUDE_FILE_CXX(windows.h HAVE_WINDOWS_H)        # src/streamindexer/filelister.cpp
 
 # files that may define the u?int{8,16,32,54}_t types
@@ -24,16 +26,41 @@ CHECK_INCLUDE_FILES(strings.h     HAVE_STRINGS_H)                      # various
 #test for some functions that are missing on a particular system
 INCLUDE(CheckFunctionExists)
 CHECK_FUNCTION_EXISTS(fchdir HAVE_FCHDIR)               # unused !
+CHECK_FUNCTION_EXISTS(fdopendir HAVE_FDOPENDIR)         # lib/filelister.cpp
+CHECK_FUNCTION_EXISTS(fstatat HAVE_FSTATAT)             # lib/filelister.cpp
 CHECK_FUNCTION_EXISTS(gettimeofday HAVE_GETTIMEOFDAY)   # src/luceneindexer/cluceneindexmanager.cpp, src/luceneindexer/cluceneindexreader.cpp, src/streams/strigi/timeofday.h
 CHECK_FUNCTION_EXISTS(isblank HAVE_ISBLANK)             # src/streams/mailinputstream.cpp, src/streams/strigi/compat.cpp
 CHECK_FUNCTION_EXISTS(mkstemp HAVE_MKSTEMP)             # src/streamanalyzer/helperendanalyzer.cpp
 CHECK_FUNCTION_EXISTS(nanosleep HAVE_NANOSLEEP)         # src/storage/sqlitestorage.cpp, src/daemon/indexscheduler.cpp, src/searchclient/cmdlinestrigi.cpp
+CHECK_FUNCTION_EXISTS(openat HAVE_OPENAT)               # lib/filelister.cpp
+CHECK_FUNCTION_EXISTS(posix_fadvise HAVE_POSIX_FADVISE)   # lib/mmapinputstream.cpp
 CHECK_FUNCTION_EXISTS(setenv HAVE_SETENV)               # src/xmlindexer/peranalyzerxml.cpp
 CHECK_FUNCTION_EXISTS(strcasecmp HAVE_STRCASECMP)       # src/streamindexer/expatsaxendanalyzer.cpp, src/streamindexer/saxendanalyzer.cpp
 CHECK_FUNCTION_EXISTS(strcasestr HAVE_STRCASESTR)       # src/streams/mailinputstream.cpp
 CHECK_FUNCTION_EXISTS(strlwr HAVE_STRLWR)               # src/streamindexer/ifilterendanalyzer.cpp
 CHECK_FUNCTION_EXISTS(strncasecmp HAVE_STRNCASECMP)     # src/streams/mailinputstream.cpp
 
+# clock_gettime lives in librt on older glibc
+INCLUDE(CheckLibraryExists)
+CHECK_LIBRARY_EXISTS(rt clock_gettime "" HAVE_LIBRT)    # lib/analyzertimer.h
+
+# io_uring is used through the system calls, so only the kernel header with
+# the operations that are used is needed
+if(ENABLE_IO_URING)
+  INCLUDE(CheckCXXSourceCompiles)
+  CHECK_CXX_SOURCE_COMPILES("
+    #include <linux/io_uring.h>
+    #include <sys/syscall.h>
+    int main() {
+      return IORING_OP_OPENAT + IORING_OP_READ + IORING_FEAT_SINGLE_MMAP
+        + __NR_io_uring_setup + __NR_io_uring_enter;
+    }" HAVE_IO_URING)                                   # lib/uringreader.cpp
+endif()
+
+#test for members of system structures
+INCLUDE(CheckStructHasMember)
+CHECK_STRUCT_HAS_MEMBER("struct dirent" d_type dirent.h HAVE_DIRENT_D_TYPE) # lib/filelister.cpp
+
 #test for missing types
 INCLUDE(CheckTypeSize)
 
@@ -144,6 +144,16 @@ public:
      * @param length  the length of the fragment
      **/
     void addText(const char* text, int32_t length);
+    /**
+     * Associate a fragment of text that is known to be valid utf8 with the
+     * file. This is the same as addText() but does not check the encoding
+     * of the text again. Use it when the analyzer has validated the text
+     * already, e.g. to find out where the valid text ends.
+     *
+     * @param text    a pointer to a fragment of valid utf8 encoded text
+     * @param length  the length of the fragment
+     **/
+    void addValidUtf8Text(const char* text, int32_t length);
     /**
      * Associate a value for a field with the file.
      *
@@ -205,6 +215,27 @@ public:
      **/
     void addTriplet(const std::string& subject, const std::string& predicate,
         const std::string& object);
+    /**
+     * Associate an RDF triplet with the file. The predicate is a symbol
+     * that was registered with FieldRegister::registerSymbol().
+     *
+     * @param subject
+     * @param predicate the id of the predicate
+     * @param object
+     **/
+    void addTriplet(const std::string& subject, uint32_t predicate,
+        const std::string& object);
+    /**
+     * Associate an RDF triplet with the file. The predicate and the object
+     * are symbols that were registered with FieldRegister::registerSymbol(),
+     * e.g. rdf:type and a class.
+     *
+     * @param subject
+     * @param predicate the id of the predicate
+     * @param object the id of the object
+     **/
+    void addTriplet(const std::string& subject, uint32_t predicate,
+        uint32_t object);
     /**
      * Associate a name/value pair for a field with the file.
      *
@@ -344,6 +375,29 @@ public:
      * the associated file.
      */
     const StreamEndAnalyzer* endAnalyzer() const;
+    /**
+     * @brief Check whether the time budget for analyzing the file has not
+     * been used up yet.
+     *
+     * The budget is set with AnalyzerConfiguration::setTimeBudget() and
+     * covers the top-level file and all files embedded in it. Analyzers
+     * that can take a long time should call this at convenient points,
+     * like AnalyzerConfiguration::indexMore(), and return early when it
+     * returns false.
+     *
+     * When the budget has been used up, this result and its parents are
+     * marked as truncated.
+     *
+     * @return true if the analysis may continue
+     **/
+    bool withinTimeBudget();
+    /**
+     * @brief Check whether the analysis of the file stopped early because
+     * the time budget ran out.
+     *
+     * IndexWriter implementations can use this in finishAnalysis().
+     **/
+    bool isTruncated() const;
 };
 
 } // end namespace Strigi
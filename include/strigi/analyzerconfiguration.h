@@ -67,6 +67,7 @@ enum FieldType {
                              should be tokenized. */
 };
 private:
+friend class AnalyzerConfigurationPrivate;
     AnalyzerConfigurationPrivate* const p;
 public:
     AnalyzerConfiguration();
@@ -216,6 +217,145 @@ public:
     virtual int64_t maximalStreamReadLength(const Strigi::AnalysisResult&/*ar*/) {
         return -1;
     }
+    /**
+     * @brief Let the StreamAnalyzer learn in which order to try the end
+     * analyzers.
+     *
+     * When an end analyzer accepts the header of a stream but then fails,
+     * the stream is reset and the next analyzer is tried. In adaptive mode
+     * the success rate of each end analyzer is recorded per kind of stream
+     * and the analyzers that are most likely to succeed are tried first.
+     * The priorities set with StreamAnalyzerFactory::setPriority() are
+     * always respected.
+     *
+     * The default is false.
+     **/
+    void setAdaptiveEndAnalyzerOrder(bool adaptive);
+    bool adaptiveEndAnalyzerOrder() const;
+    /**
+     * @brief Read the files that are indexed through a memory mapping.
+     *
+     * A mapping lets the analyzers read the data without copying it. But
+     * reading a mapped page of a file that was truncated in the meantime
+     * raises SIGBUS. So when this is enabled, the first file that is mapped
+     * installs a process-wide SIGBUS handler. The handler turns such a
+     * fault into a read error and passes all other faults on to the handler
+     * that was installed before. An application that installs its own
+     * SIGBUS handler later must leave this disabled.
+     *
+     * The default is false: files are read with a buffered
+     * FileInputStream.
+     **/
+    void setMemoryMapping(bool map);
+    bool memoryMapping() const;
+    /**
+     * @brief Save the learned end analyzer order to the file @p path.
+     *
+     * @return true if the file was written
+     **/
+    bool saveEndAnalyzerOrder(const std::string& path) const;
+    /**
+     * @brief Load an end analyzer order that was saved with
+     * saveEndAnalyzerOrder().
+     *
+     * The loaded counts are added to the counts that have been learned
+     * already.
+     *
+     * @return true if the file could be read
+     **/
+    bool loadEndAnalyzerOrder(const std::string& path);
+    /**
+     * @brief The number of nesting levels for which a StreamAnalyzer keeps
+     * its analyzer instances between files.
+     *
+     * A StreamAnalyzer needs a set of analyzers for every level of nesting,
+     * e.g. a file in a zip file in a tar file needs three levels. After a
+     * top-level file has been analyzed, the analyzers of the levels beyond
+     * this depth are deleted. The default is 3.
+     **/
+    int analyzerCacheDepth() const;
+    void setAnalyzerCacheDepth(int depth);
+    /**
+     * @brief The maximal number of bytes of text that is passed to the
+     * IndexWriter for one file.
+     *
+     * Text that is added with AnalysisResult::addText() beyond this amount
+     * is dropped, so the memory that a writer needs to collect the text of
+     * a file is bounded. Embedded files each have their own limit. The
+     * default is 16 MB, -1 means no limit.
+     **/
+    int64_t maximalTextLength() const;
+    void setMaximalTextLength(int64_t bytes);
+    /**
+     * @brief Set the default time budget for analyzing a file.
+     *
+     * When the budget for a file has been used up, the analyzers stop at
+     * the next convenient point, see AnalysisResult::withinTimeBudget().
+     * The budget covers the file and all files embedded in it.
+     *
+     * @param ms the budget in milliseconds, 0 (the default) means no limit
+     **/
+    void setTimeBudget(int32_t ms);
+    /**
+     * @brief Set the time budget for files of a particular type.
+     *
+     * @param key a MIME type or the name of an end analyzer, e.g.
+     *            "application/pdf" or "PdfEndAnalyzer"
+     * @param ms the budget in milliseconds, 0 means no limit
+     **/
+    void setTimeBudget(const std::string& key, int32_t ms);
+    /**
+     * @brief Return the time budget for a file that is analyzed by the end
+     * analyzer called @p endanalyzer and that has MIME type @p mimetype.
+     *
+     * This is the smallest of the default budget and the budgets for the
+     * end analyzer and the MIME type.
+     *
+     * @return the budget in milliseconds or 0 if there is no limit
+     **/
+    int32_t timeBudget(const std::string& endanalyzer,
+        const std::string& mimetype) const;
+    /**
+     * @brief Check if any time budget has been set.
+     **/
+    bool hasTimeBudget() const;
+    /**
+     * @brief The number of files that DirAnalyzer opens and reads ahead of
+     * its analysis threads.
+     *
+     * When this is larger than 0, a few I/O threads take files from the
+     * DirLister, open them and read their first bytes into memory while the
+     * analysis threads are busy with earlier files. This lets disk and cpu
+     * work overlap, which helps most on spinning disks and network mounts.
+     *
+     * The default is 0, which disables reading ahead.
+     **/
+    int prefetchDepth() const;
+    void setPrefetchDepth(int depth);
+    /**
+     * @brief The maximal number of bytes held by files that have been read
+     * ahead but not yet analyzed.
+     *
+     * The default is 32 MB.
+     **/
+    int64_t prefetchMemory() const;
+    void setPrefetchMemory(int64_t bytes);
+    /**
+     * @brief The number of bytes that are read ahead from the start of
+     * each file.
+     *
+     * Files that are not larger than prefetchWholeFileSize() are read
+     * completely. The default is 64 kB.
+     **/
+    int32_t prefetchSize() const;
+    void setPrefetchSize(int32_t bytes);
+    /**
+     * @brief Files up to this size are read ahead completely.
+     *
+     * The default is 1 MB.
+     **/
+    int32_t prefetchWholeFileSize() const;
+    void setPrefetchWholeFileSize(int32_t bytes);
     /**
      * @brief Determine the field indexing properties of a field.
      *
@@ -0,0 +1,86 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef STRIGI_ANALYZERSTATISTICS_H
+#define STRIGI_ANALYZERSTATISTICS_H
+
+#include <strigi/strigiconfig.h>
+#include <string>
+#include <vector>
+
+namespace Strigi {
+
+/**
+ * @brief Performance counters for one analyzer at one depth.
+ *
+ * A StreamAnalyzer keeps one of these for every through, end and event
+ * analyzer it runs. Line and SAX analyzers are run from within the
+ * LineEventAnalyzer and SaxEventAnalyzer event analyzers and are accounted
+ * under those names.
+ *
+ * The counters are owned by the StreamAnalyzer that updates them, so no
+ * locking is needed while analyzing. Counters from several StreamAnalyzer
+ * instances, e.g. the threads of a DirAnalyzer, are combined with merge().
+ **/
+class STREAMANALYZER_EXPORT AnalyzerStatistics {
+public:
+    enum Type { Through, End, Event };
+
+    /** the name of the analyzer as returned by its name() function */
+    std::string name;
+    Type type;
+    /** the depth of the streams the analyzer was used on */
+    int depth;
+    /** the number of streams the analyzer was offered */
+    uint64_t invocations;
+    /** for end analyzers: the number of times checkHeader() returned true */
+    uint64_t headerHits;
+    /** the number of bytes that passed the analyzer */
+    uint64_t bytes;
+    /** wall clock time spent in the analyzer in microseconds */
+    uint64_t wallTime;
+    /** cpu time spent in the analyzer in microseconds */
+    uint64_t cpuTime;
+    /** for end analyzers: the number of times analyze() failed */
+    uint64_t failures;
+    /** for end analyzers: the number of times the stream was reset after
+     *  a failure */
+    uint64_t resets;
+    /** for end analyzers: the number of times the analysis stopped early
+     *  because the time budget for the file ran out */
+    uint64_t budgetHits;
+
+    AnalyzerStatistics() :type(Through), depth(0), invocations(0),
+        headerHits(0), bytes(0), wallTime(0), cpuTime(0), failures(0),
+        resets(0), budgetHits(0) {}
+    /**
+     * @brief Add the counters of @p s to these counters.
+     **/
+    void add(const AnalyzerStatistics& s);
+    /**
+     * @brief Add the statistics in @p from to the statistics in @p to.
+     *
+     * Entries with the same name, type and depth are summed, other entries
+     * are appended.
+     **/
+    static void merge(std::vector<AnalyzerStatistics>& to,
+        const std::vector<AnalyzerStatistics>& from);
+};
+
+}
+
+#endif
@@ -21,6 +21,7 @@
 #define STRIGI_DIRANALYZER_H
 
 #include <strigi/strigiconfig.h>
+#include <strigi/analyzerstatistics.h>
 #include <string>
 #include <vector>
 
@@ -49,6 +50,30 @@ public:
         AnalysisCaller* caller = 0);
     int updateDirs(const std::vector<std::string>& dirs, int nthreads = 2,
         AnalysisCaller* caller = 0);
+    /**
+     * @brief Keep the index up to date with the directories @p dirs until
+     * @p caller says to stop.
+     *
+     * The directories are first updated as with updateDirs() and are then
+     * watched for changes. Only the files that changed are analyzed again
+     * or removed from the index, once they have not changed for a few
+     * seconds. If the system drops change events, the directories are
+     * updated again as a whole. Without a caller this function does not
+     * return.
+     *
+     * @return -1 if the directories cannot be watched on this system or if
+     *         there are too many of them; call updateDirs() now and then
+     *         instead
+     **/
+    int watchDirs(const std::vector<std::string>& dirs, int nthreads = 2,
+        AnalysisCaller* caller = 0);
+    /**
+     * @brief Retrieve the performance counters of all analyzers used by
+     * this DirAnalyzer, summed over all threads.
+     *
+     * Call this when no analysis is running.
+     **/
+    std::vector<AnalyzerStatistics> statistics() const;
 };
 }
 #endif
@@ -0,0 +1,93 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef STRIGI_DOCUMENTRECORD_H
+#define STRIGI_DOCUMENTRECORD_H
+
+#include <strigi/strigiconfig.h>
+#include <string>
+#include <vector>
+
+namespace Strigi {
+
+class RegisteredField;
+
+/**
+ * @brief The field values of one document in a compact form.
+ *
+ * When its IndexWriter asks for it, see
+ * IndexWriter::acceptsDocumentRecords(), an AnalysisResult collects the
+ * values added to it in a DocumentRecord and hands the record to the writer
+ * in one call when the document is finished. The values are kept in one
+ * contiguous buffer, so once the buffer has grown, collecting values costs
+ * no allocation and no virtual call per value.
+ **/
+class STREAMANALYZER_EXPORT DocumentRecord {
+public:
+    enum Type { String, Int32, UInt32, Double };
+    /**
+     * @brief The description of one value in the record.
+     **/
+    struct Entry {
+        const RegisteredField* field;
+        Type type;
+        /** the position of the value in the buffer */
+        uint32_t offset;
+        /** the number of bytes of the value */
+        uint32_t size;
+    };
+private:
+    std::vector<Entry> m_entries;
+    std::string m_data;
+
+    void append(const RegisteredField* field, Type type, const char* data,
+        uint32_t size);
+public:
+    /**
+     * @brief Remove all values but keep the allocated memory.
+     **/
+    void clear() {
+        m_entries.clear();
+        m_data.clear();
+    }
+    bool empty() const { return m_entries.empty(); }
+    /**
+     * @brief The number of values in the record.
+     **/
+    uint32_t size() const { return (uint32_t)m_entries.size(); }
+    const Entry& entry(uint32_t i) const { return m_entries[i]; }
+
+    void add(const RegisteredField* field, const char* data, uint32_t size) {
+        append(field, String, data, size);
+    }
+    void add(const RegisteredField* field, int32_t value);
+    void add(const RegisteredField* field, uint32_t value);
+    void add(const RegisteredField* field, double value);
+
+    /**
+     * @brief The bytes of the value of @p e. For String values these are
+     * utf8 encoded and not 0-terminated.
+     **/
+    const char* data(const Entry& e) const { return m_data.data() + e.offset; }
+    int32_t int32Value(const Entry& e) const;
+    uint32_t uint32Value(const Entry& e) const;
+    double doubleValue(const Entry& e) const;
+};
+
+}
+
+#endif
@@ -25,6 +25,7 @@
 #include "fieldproperties.h"
 #include <map>
 #include <string>
+#include <vector>
 
 namespace Strigi {
 
@@ -49,6 +50,7 @@ private:
     const RegisteredField* m_parent; /**< TODO (neksa): should go! **/
     void* m_writerdata;		/**< to be used by a Strigi::IndexWriter to store data*/
     const FieldProperties& m_properties; /**< reference to the object holding all FieldProperties for this field **/
+    int m_id;			/**< number of this field in its FieldRegister **/
 
     RegisteredField();
     /**
@@ -122,6 +124,15 @@ public:
      * @brief The type of the data in this field.
      */
     const std::string& type() const { return m_type; }
+    /**
+     * @brief A small number that identifies this field in its
+     * FieldRegister.
+     *
+     * The fields of a FieldRegister are numbered from 0 in the order in
+     * which they are registered, so the id can be used as an index into an
+     * array with an entry for each field.
+     */
+    int id() const { return m_id; }
 };
 
 /**
@@ -134,6 +145,8 @@ public:
 class STREAMANALYZER_EXPORT FieldRegister {
 private:
     std::map<std::string, RegisteredField*> m_fields;
+    std::map<std::string, uint32_t> m_symbolids;
+    std::vector<std::string> m_symbols;
 public:
     FieldRegister();
     ~FieldRegister();
@@ -194,6 +207,31 @@ public:
     std::map<std::string, RegisteredField*>& fields() {
         return m_fields;
     }
+    /**
+     * @brief Register a symbol with the FieldRegister.
+     *
+     * Symbols are uris that occur over and over again in triplets, such as
+     * predicates and the classes of objects. Analyzers register them in
+     * registerFields() and pass the returned id to
+     * Strigi::AnalysisResult::addTriplet(), so the uri is not passed
+     * around as a string for each triplet and index writers can store it
+     * in compact form.
+     *
+     * The symbols are numbered from 0 in the order in which they are
+     * registered. Registering a uri again returns the same id.
+     *
+     * @param uri the uri of the symbol
+     * @return the id of the symbol
+     */
+    uint32_t registerSymbol(const std::string& uri);
+    /**
+     * @brief Get the uri of the symbol with the id @p id.
+     */
+    const std::string& symbol(uint32_t id) const { return m_symbols[id]; }
+    /**
+     * @brief Get the number of symbols that have been registered.
+     */
+    uint32_t symbolCount() const { return (uint32_t)m_symbols.size(); }
 
     /** The type name to use with registerField for fields that will
      * store a float value */
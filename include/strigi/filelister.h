@@ -83,11 +83,22 @@ public:
     void stopListing();
 
     /**
-     * Thread-safe function for getting the next filename.
-     * @return 0 when no error occurred or -1 if an error occurred
+     * Thread-safe function for getting the next directory. When another
+     * thread is still listing a directory, this waits until that thread
+     * has found new directories or is done.
+     * @return 0 when no error occurred or -1 if an error occurred or if
+     *         there are no more directories
      */
     int nextDir(std::string& path,
         std::vector<std::pair<std::string, struct stat> >& dirs);
+    /**
+     * Same as nextDir(path, dirs), but for a thread that calls it repeatedly
+     * with its own @p worker number, starting at 0. Each worker has its own
+     * queue of directories and only takes directories from the queues of
+     * other workers when its own queue is empty.
+     */
+    int nextDir(int worker, std::string& path,
+        std::vector<std::pair<std::string, struct stat> >& dirs);
 
     void skipTillAfter(const std::string& lastToSkip);
 };
@@ -37,6 +37,19 @@ class Query;
  **/
 class STREAMANALYZER_EXPORT IndexReader {
 public:
+    /**
+     * Receives the files in the index from listFiles().
+     **/
+    class FileHandler {
+    public:
+        virtual ~FileHandler() {}
+        /**
+         * Is called for each file in the index.
+         *
+         * @return false to stop the listing
+         **/
+        virtual bool handleFile(const std::string& path, time_t mtime) = 0;
+    };
     virtual ~IndexReader() {}
     /**
      * Count the number of documents that reside in this index and that match
@@ -128,6 +141,18 @@ public:
         const std::string& keywordmatch,
         const std::vector<std::string>& fieldnames,
         uint32_t max, uint32_t offset) = 0;
+    /**
+     * Pass the path and mtime of all files in the index to @p handler,
+     * sorted by path.
+     *
+     * Updating a large index is much faster with one pass over all files
+     * than with a call to getChildren() for each directory. Indexes that
+     * cannot list their files efficiently do not implement this function.
+     *
+     * @return true if the files were listed, false if the index does not
+     *         support listing all files and getChildren() has to be used
+     **/
+    virtual bool listFiles(FileHandler& /*handler*/) { return false; }
 };
 
 }
@@ -31,6 +31,7 @@ template <class T> class StreamBase;
 class FieldRegister;
 
 class AnalysisResult;
+class DocumentRecord;
 class RegisteredField;
 
 /**
@@ -247,6 +248,60 @@ public:
      */
     virtual void releaseWriterData(const Strigi::FieldRegister &/*fieldRegister*/) {
     }
+    /**
+     * @brief Whether the writer takes the values of a document in one
+     * DocumentRecord.
+     *
+     * If this returns true, AnalysisResult does not call the addValue()
+     * functions that take a single string, binary, integer or double
+     * value. It collects these values instead and passes them to
+     * addValues() just before finishAnalysis(). Text, name/value pairs and
+     * triplets are still passed as they come.
+     *
+     * The default implementation returns false.
+     */
+    virtual bool acceptsDocumentRecords() const { return false; }
+    /**
+     * @brief Add all values collected for a document to the index.
+     *
+     * This is only called if acceptsDocumentRecords() returns true.
+     *
+     * @param result the AnalysisResult for the object that is
+     * being analyzed
+     * @param record the values of the object
+     */
+    virtual void addValues(const AnalysisResult* /*result*/,
+        const DocumentRecord& /*record*/) {}
+    /**
+     * @brief Add an RDF triplet with a predicate that is a symbol.
+     *
+     * See FieldRegister::registerSymbol(). Writers can override this to
+     * store the triplet in compact form. The default implementation looks
+     * up the uri of the predicate and calls the addTriplet() function
+     * that takes strings.
+     *
+     * @param result the AnalysisResult that the triplet belongs to
+     * @param subject
+     * @param predicate the id of the predicate
+     * @param object
+     **/
+    virtual void addTriplet(const AnalysisResult* result,
+        const std::string& subject, uint32_t predicate,
+        const std::string& object);
+    /**
+     * @brief Add an RDF triplet with a predicate and an object that are
+     * symbols.
+     *
+     * The default implementation looks up the uris and calls the
+     * addTriplet() function that takes strings.
+     *
+     * @param result the AnalysisResult that the triplet belongs to
+     * @param subject
+     * @param predicate the id of the predicate
+     * @param object the id of the object
+     **/
+    virtual void addTriplet(const AnalysisResult* result,
+        const std::string& subject, uint32_t predicate, uint32_t object);
 };
 
 } // end namespace Strigi
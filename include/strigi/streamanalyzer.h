@@ -21,7 +21,9 @@
 #define STRIGI_STREAMANALYZER_H
 
 #include <strigi/strigiconfig.h>
+#include <strigi/analyzerstatistics.h>
 #include <string>
+#include <vector>
 
 
 namespace Strigi {
@@ -57,6 +59,16 @@ public:
     signed char indexFile(const std::string& filepath);
     signed char analyze(AnalysisResult& idx, StreamBase<char> *input);
     AnalyzerConfiguration& configuration() const;
+    /**
+     * @brief Retrieve the performance counters of the analyzers used by this
+     * StreamAnalyzer.
+     *
+     * The counters are accumulated since the construction of this
+     * StreamAnalyzer. There is one entry per analyzer and depth.
+     * This function should be called from the thread that uses this
+     * StreamAnalyzer or when no analysis is running.
+     **/
+    std::vector<AnalyzerStatistics> statistics() const;
 };
 }
 
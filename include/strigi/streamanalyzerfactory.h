@@ -23,6 +23,7 @@
 
 #include <strigi/strigiconfig.h>
 
+#include <string>
 #include <vector>
 
 namespace Strigi {
@@ -30,6 +31,16 @@ namespace Strigi {
 class FieldRegister;
 class RegisteredField;
 
+/**
+ * @brief A fixed sequence of bytes at a fixed offset in a stream.
+ *
+ * See StreamAnalyzerFactory::addSignature().
+ */
+struct StreamSignature {
+    int32_t offset;
+    std::string magic;
+};
+
 /**
  * The StreamAnalyzerFactory class
  */
@@ -52,6 +63,39 @@ public:
     virtual void registerFields(FieldRegister&) = 0;
     void addField(const RegisteredField*);
     const std::vector<const RegisteredField*>& registeredFields() const;
+    /**
+     * @brief Declare a magic byte sequence that a stream must contain for the
+     * analyzers of this factory to be interested in it.
+     *
+     * This is used by StreamEndAnalyzerFactory implementations to let the
+     * StreamAnalyzer skip StreamEndAnalyzer::checkHeader() on streams that
+     * cannot match. If a factory declares several signatures, a stream
+     * needs to match only one of them. A factory that declares no signatures
+     * gets all streams passed to checkHeader().
+     *
+     * Only declare signatures that are a necessary condition for checkHeader()
+     * to return true.
+     *
+     * @param magic the bytes that must be present
+     * @param length the number of bytes in @p magic
+     * @param offset the position in the stream where @p magic must occur
+     */
+    void addSignature(const char* magic, int32_t length, int32_t offset = 0);
+    const std::vector<StreamSignature>& signatures() const;
+    /**
+     * @brief Set the priority of the analyzers of this factory.
+     *
+     * StreamEndAnalyzers are normally tried in the order in which their
+     * factories were loaded. When the StreamAnalyzer reorders them, see
+     * AnalyzerConfiguration::setAdaptiveEndAnalyzerOrder(), analyzers with
+     * a higher priority are still always tried before analyzers with a
+     * lower priority. Use this for analyzers that must get a stream before
+     * more generic analyzers that would also accept it.
+     *
+     * @param priority the priority, the default is 0
+     */
+    void setPriority(int priority);
+    int priority() const;
 };
 
 }
@@ -26,6 +26,17 @@
 namespace Strigi {
 class AnalysisResult;
 
+/**
+ * @brief A line of utf8 text that is passed to
+ * StreamLineAnalyzer::handleLines().
+ *
+ * The data is not null-terminated and only valid during the call.
+ */
+struct LineView {
+    const char* data;
+    uint32_t length;
+};
+
 /**
  * This class is especially well suited for file formats that are based on
  * lines of plain text, i.e. where a line break indicates information separation,
@@ -76,6 +87,20 @@ public:
      * \return true if you are finished with this stream, false otherwise
      */
     virtual bool isReadyWithStream() = 0;
+    /**
+     * Is called with all the lines that were found in a block of the
+     * stream. The default implementation calls handleLine() for each line
+     * until isReadyWithStream() returns true. Analyzers that do little
+     * work per line can reimplement this to save a virtual call per line.
+     * It is declared last to keep the vtable of older plugins valid.
+     * \param lines the lines in the order in which they occur
+     * \param n the number of lines
+     */
+    virtual void handleLines(const LineView* lines, uint32_t n) {
+        for (uint32_t i = 0; i < n && !isReadyWithStream(); ++i) {
+            handleLine(lines[i].data, lines[i].length);
+        }
+    }
 };
 
 /**
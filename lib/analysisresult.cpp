@@ -24,9 +24,13 @@
 
 #include "analysisresult.h"
 #include "indexwriter.h"
+#include "documentrecord.h"
 #include "analyzerconfiguration.h"
 #include "streamanalyzer.h"
+#include "streamendanalyzer.h"
 #include "strigi_thread.h"
+#include "analyzertimer.h"
+#include "utf8validator.h"
 
 #include <strigi/strigiconfig.h>
 #include <strigi/streambase.h>
@@ -35,73 +39,82 @@
 #include <time.h>
 #include <string>
 #include <cstdlib>
-#include <iconv.h>
 #include <cassert>
 #include <iostream>
+#include <algorithm>
 #include <map>
-
-#ifdef ICONV_SECOND_ARGUMENT_IS_CONST
-     #define ICONV_CONST const
-#else
-     #define ICONV_CONST
-#endif
+#include <vector>
 
 using namespace Strigi;
 using namespace std;
 
-class Latin1Converter {
-    iconv_t const conv;
-    char* out;
-    size_t outlen;
-    STRIGI_MUTEX_DEFINE(mutex);
-
-    int32_t _fromLatin1(char*& out, const char* data, size_t len);
-    Latin1Converter() :conv(iconv_open("UTF-8", "ISO-8859-1")), outlen(0) {
-        STRIGI_MUTEX_INIT(&mutex);
-    }
-    ~Latin1Converter() {
-        iconv_close(conv);
-        free(out);
-        STRIGI_MUTEX_DESTROY(&mutex);
+/**
+ * Convert ISO-8859-1 to UTF-8. Each Latin-1 byte is the code point of the
+ * same value, so no conversion tables or shared iconv state are needed and
+ * the conversion can run in any number of threads at once.
+ * @p out must have room for 2*@p len bytes.
+ **/
+static int32_t
+latin1ToUtf8(char* out, const char* data, int32_t len) {
+    const unsigned char* in = (const unsigned char*)data;
+    const unsigned char* const e = in + len;
+    unsigned char* o = (unsigned char*)out;
+    while (in < e) {
+        unsigned char c = *in++;
+        if (c < 0x80) {
+            *o++ = c;
+        } else {
+            *o++ = (unsigned char)(0xC0 | (c >> 6));
+            *o++ = (unsigned char)(0x80 | (c & 0x3F));
+        }
     }
-    static Latin1Converter& converter() {
-        static Latin1Converter l;
-        return l;
+    return (int32_t)(o - (unsigned char*)out);
+}
+
+namespace {
+/**
+ * Hands out a serial number to each top-level AnalysisResult. Together with
+ * a prefix that is chosen once per process, the serial makes the anonymous
+ * uris of all files distinct while each uri is made without a lock.
+ **/
+class AnonymousUriSerials {
+private:
+    StrigiMutex mutex;
+    uint32_t next;
+
+    AnonymousUriSerials() :next(0) {
+        // mix the start time with the address of this object, which
+        // differs between processes when address randomization is used
+        uint64_t z = (uint64_t)AnalyzerTimer::now(false)
+            ^ ((uint64_t)(size_t)this << 16);
+        // splitmix64 finalizer
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        prefix = (uint32_t)(z ^ (z >> 31));
     }
 public:
-    static int32_t fromLatin1(char*& out, const char* data, int32_t len) {
-        return converter()._fromLatin1(out, data, len);
-    }
-    static void lock() {
-        STRIGI_MUTEX_LOCK(&converter().mutex);
+    uint32_t prefix;
+
+    static AnonymousUriSerials& serials() {
+        static AnonymousUriSerials s;
+        return s;
     }
-    static void unlock() {
-        STRIGI_MUTEX_UNLOCK(&converter().mutex);
+    uint32_t serial() {
+        mutex.lock();
+        uint32_t n = next++;
+        mutex.unlock();
+        return n;
     }
 };
-int32_t
-Latin1Converter::_fromLatin1(char*& o, const char* data, size_t len) {
-    size_t l = 3*len;
-    if (outlen < l) {
-        out = (char*)realloc(out, l);
-        outlen = l;
-    } else {
-        l = outlen;
-    }
-    o = out;
-    ICONV_CONST char* inp = (char*)data;
-    char* outp = out;
-    iconv(conv, &inp, &len, &outp, &l);
-    return (len == 0) ?(int32_t)(outlen-l) :0;
 }
 
 class AnalysisResult::Private {
 public:
     int64_t m_id;
     mutable void* m_writerData;
-    const time_t m_mtime;
+    time_t m_mtime;
     std::string m_name;
-    const std::string m_path;
+    std::string m_path;
     const std::string m_parentpath; // only use this value of m_parent == 0
     std::string m_encoding;
     std::string m_mimetype;
@@ -112,16 +125,48 @@ public:
     AnalysisResult* const m_this;
     AnalysisResult* const m_parent;
     const StreamEndAnalyzer* m_endanalyzer;
-    std::map<const Strigi::RegisteredField*, int> m_occurrences;
+    // number of values per field, indexed by RegisteredField::id()
+    std::vector<int> m_occurrences;
     AnalysisResult* m_child;
+    // A finished child that is reused for the next child. Its strings and
+    // buffers, and those of its own spare child, keep their capacity, so
+    // the members of an archive are analyzed without new allocations.
+    AnalysisResult* m_spare;
+    // the path of the last child, built in place
+    std::string m_childpath;
+    bool m_finished;
+    // start of the analysis in microseconds, only set at depth 0
+    int64_t m_starttime;
+    bool m_truncated;
+    // numbering of the anonymous uris, only used at depth 0
+    uint32_t m_uriserial;
+    uint32_t m_uricount;
+    // buffer for text that is converted from latin1
+    std::vector<char> m_utf8;
+    // the number of bytes of text passed to the writer
+    int64_t m_textlength;
+    // the values that are passed to the writer in one go, if it wants that
+    const bool m_batch;
+    DocumentRecord m_record;
 
     Private(const std::string& p, const char* name, time_t mt,
         AnalysisResult& t, AnalysisResult& parent);
     Private(const std::string& p, time_t mt, IndexWriter& w,
         StreamAnalyzer& indexer, const string& parentpath, AnalysisResult& t);
     void write();
+    void finish();
+    void reset(const std::string& path, const char* name, time_t mt);
+    void recycleChild();
+    void writeText(const char* text, int32_t length);
+    void writeValue(const RegisteredField* field, const std::string& value);
+    void writeValue(const RegisteredField* field, const char* data,
+        uint32_t size);
+    void writeValue(const RegisteredField* field, int32_t value);
+    void writeValue(const RegisteredField* field, uint32_t value);
+    void writeValue(const RegisteredField* field, double value);
 
     bool checkCardinality(const RegisteredField* field);
+    int32_t fromLatin1(const char*& out, const char* data, int32_t len);
 };
 
 AnalysisResult::Private::Private(const std::string& p, const char* name,
@@ -131,7 +176,10 @@ AnalysisResult::Private::Private(const std::string& p, const char* name,
              m_indexer(parent.p->m_indexer),
              m_analyzerconfig(parent.p->m_analyzerconfig),
              m_this(&t), m_parent(&parent),
-             m_endanalyzer(0), m_child(0) {
+             m_endanalyzer(0), m_child(0), m_spare(0), m_finished(false),
+             m_starttime(0), m_truncated(false), m_uriserial(0),
+             m_uricount(0), m_textlength(0),
+             m_batch(m_writer.acceptsDocumentRecords()) {
     // make sure that the path starts with the path of the parent
     assert(m_path.size() > m_parent->p->m_path.size()+1);
     assert(m_path.compare(0, m_parent->p->m_path.size(), m_parent->p->m_path)
@@ -141,7 +189,6 @@ AnalysisResult::AnalysisResult(const std::string& path, const char* name,
         time_t mt, AnalysisResult& parent)
         :p(new Private(path, name, mt, *this, parent)) {
     p->m_writer.startAnalysis(this);
-    srand((unsigned int)time(NULL));
 }
 AnalysisResult::Private::Private(const std::string& p, time_t mt,
         IndexWriter& w, StreamAnalyzer& indexer, const string& parentpath,
@@ -149,7 +196,13 @@ AnalysisResult::Private::Private(const std::string& p, time_t mt,
             :m_writerData(0), m_mtime(mt), m_path(p), m_parentpath(parentpath),
              m_writer(w), m_depth(0), m_indexer(indexer),
              m_analyzerconfig(indexer.configuration()), m_this(&t),
-             m_parent(0), m_endanalyzer(0), m_child(0) {
+             m_parent(0), m_endanalyzer(0), m_child(0), m_spare(0),
+             m_finished(false), m_truncated(false),
+             m_uriserial(AnonymousUriSerials::serials().serial()),
+             m_uricount(0), m_textlength(0),
+             m_batch(m_writer.acceptsDocumentRecords()) {
+    m_starttime = (m_analyzerconfig.hasTimeBudget())
+        ?AnalyzerTimer::now(false) :0;
     size_t pos = m_path.rfind('/'); // TODO: perhaps us '\\' on Windows
     if (pos == std::string::npos) {
         m_name = m_path;
@@ -180,27 +233,131 @@ AnalysisResult::AnalysisResult(const std::string& path, time_t mt,
     p->m_writer.startAnalysis(this);
 }
 AnalysisResult::~AnalysisResult() {
-    // delete child before writing and deleting the parent
-    delete p->m_child;
-    p->write();
+    if (!p->m_finished) {
+        p->finish();
+    }
+    delete p->m_spare;
     delete p;
 }
 void
+AnalysisResult::Private::finish() {
+    // finish the child before writing the parent
+    recycleChild();
+    write();
+    m_finished = true;
+}
+void
+AnalysisResult::Private::writeValue(const RegisteredField* field,
+        const std::string& value) {
+    if (m_batch) {
+        m_record.add(field, value.c_str(), (uint32_t)value.length());
+    } else {
+        m_writer.addValue(m_this, field, value);
+    }
+}
+void
+AnalysisResult::Private::writeValue(const RegisteredField* field,
+        const char* data, uint32_t size) {
+    if (m_batch) {
+        m_record.add(field, data, size);
+    } else {
+        m_writer.addValue(m_this, field, (const unsigned char*)data, size);
+    }
+}
+void
+AnalysisResult::Private::writeValue(const RegisteredField* field,
+        int32_t value) {
+    if (m_batch) {
+        m_record.add(field, value);
+    } else {
+        m_writer.addValue(m_this, field, value);
+    }
+}
+void
+AnalysisResult::Private::writeValue(const RegisteredField* field,
+        uint32_t value) {
+    if (m_batch) {
+        m_record.add(field, value);
+    } else {
+        m_writer.addValue(m_this, field, value);
+    }
+}
+void
+AnalysisResult::Private::writeValue(const RegisteredField* field,
+        double value) {
+    if (m_batch) {
+        m_record.add(field, value);
+    } else {
+        m_writer.addValue(m_this, field, value);
+    }
+}
+void
+AnalysisResult::Private::writeText(const char* text, int32_t length) {
+    const int64_t max = m_analyzerconfig.maximalTextLength();
+    if (max >= 0 && m_textlength + length > max) {
+        if (m_textlength >= max) {
+            return;
+        }
+        // pass what still fits, but do not cut a character in two
+        length = (int32_t)(max - m_textlength);
+        while (length > 0 && (text[length] & 0xC0) == 0x80) {
+            length--;
+        }
+        m_textlength = max;
+    } else {
+        m_textlength += length;
+    }
+    if (length > 0) {
+        m_writer.addText(m_this, text, length);
+    }
+}
+void
+AnalysisResult::Private::recycleChild() {
+    if (m_child == 0) return;
+    m_child->p->finish();
+    // there is no spare while a child exists, the child was made from it
+    assert(m_spare == 0);
+    m_spare = m_child;
+    m_child = 0;
+}
+void
+AnalysisResult::Private::reset(const std::string& path, const char* name,
+        time_t mt) {
+    // assign() keeps the capacity of the strings
+    m_writerData = 0;
+    m_mtime = mt;
+    m_name.assign(name);
+    m_path.assign(path);
+    m_encoding.clear();
+    m_mimetype.clear();
+    m_endanalyzer = 0;
+    std::fill(m_occurrences.begin(), m_occurrences.end(), 0);
+    m_record.clear();
+    m_textlength = 0;
+    m_finished = false;
+    m_starttime = 0;
+    m_truncated = false;
+    assert(m_child == 0);
+    assert(m_path.size() > m_parent->p->m_path.size()+1);
+    assert(m_path.compare(0, m_parent->p->m_path.size(), m_parent->p->m_path)
+        == 0);
+}
+void
 AnalysisResult::Private::write() {
     const FieldRegister& fr = m_analyzerconfig.fieldRegister();
-    m_writer.addValue(m_this, fr.pathField, m_path);
+    writeValue(fr.pathField, m_path);
     // get the parent directory and store it without trailing slash
-    m_writer.addValue(m_this, fr.parentLocationField,
+    writeValue(fr.parentLocationField,
         (m_parent) ?m_parent->path() :m_parentpath);
 
     if (m_encoding.length()) {
-        m_writer.addValue(m_this, fr.encodingField, m_encoding);
+        writeValue(fr.encodingField, m_encoding);
     }
     if (m_mimetype.length()) {
-        m_writer.addValue(m_this, fr.mimetypeField, m_mimetype);
+        writeValue(fr.mimetypeField, m_mimetype);
     }
     if (m_name.length()) {
-        m_writer.addValue(m_this, fr.filenameField, m_name);
+        writeValue(fr.filenameField, m_name);
     }
     string field = m_this->extension();
     if (field.length()) {
@@ -208,11 +365,15 @@ AnalysisResult::Private::write() {
     }
     //This is superfluous. You can use nie:DataObject type to find out whether you've got a file or embedded data
     //m_writer.addValue(m_this, fr.embeddepthField, (int32_t)m_depth);
-    m_writer.addValue(m_this, fr.mtimeField, (uint32_t)m_mtime);
+    writeValue(fr.mtimeField, (uint32_t)m_mtime);
 
     //FIXME a temporary workaround until we have a file(system) analyzer.
-    if(m_depth==0) m_writer.addValue(m_this, fr.typeField, "http://www.semanticdesktop.org/ontologies/2007/03/22/nfo#FileDataObject"); 
+    if(m_depth==0) writeValue(fr.typeField, "http://www.semanticdesktop.org/ontologies/2007/03/22/nfo#FileDataObject"); 
     
+    if (m_batch) {
+        m_writer.addValues(m_this, m_record);
+        m_record.clear();
+    }
     m_writer.finishAnalysis(m_this);
 }
 const std::string& AnalysisResult::fileName() const { return p->m_name; }
@@ -240,22 +401,29 @@ AnalysisResult::indexChild(const std::string& name, time_t mt,
     // clean up previous child
     finishIndexChild();
 
-    std::string path(p->m_path);
+    std::string& path = p->m_childpath;
+    path.assign(p->m_path);
     path.append("/");
     path.append(name);
     const char* n = path.c_str() + path.rfind('/') + 1;
     // check if we should index this file by applying the filename filters
     // make sure that the depth variable does not overflow
     if (depth() < 127 && p->m_analyzerconfig.indexFile(path.c_str(), n)) {
-        p->m_child = new AnalysisResult(path, n, mt, *this);
+        if (p->m_spare) {
+            p->m_child = p->m_spare;
+            p->m_spare = 0;
+            p->m_child->p->reset(path, n, mt);
+            p->m_writer.startAnalysis(p->m_child);
+        } else {
+            p->m_child = new AnalysisResult(path, n, mt, *this);
+        }
         return p->m_indexer.analyze(*p->m_child, file);
     }
     return 0;
 }
 void
 AnalysisResult::finishIndexChild() {
-    delete p->m_child;
-    p->m_child = 0;
+    p->recycleChild();
 }
 
 AnalysisResult*
@@ -264,21 +432,23 @@ AnalysisResult::child() {
 }
 void
 AnalysisResult::addText(const char* text, int32_t length) {
-    if (checkUtf8(text, length)) {
-        p->m_writer.addText(this, text, length);
+    if (validateUtf8(text, length)) {
+        p->writeText(text, length);
     } else {
-        Latin1Converter::lock();
-        char* d;
-        int32_t len = Latin1Converter::fromLatin1(d, text, length);
-        if (len && checkUtf8(d, len)) {
-            p->m_writer.addText(this, d, len);
+        const char* d;
+        int32_t len = p->fromLatin1(d, text, length);
+        if (len && validateUtf8(d, len)) {
+            p->writeText(d, len);
         } else {
             fprintf(stderr, "'%.*s' is not a UTF8 or latin1 string\n",
                 length, text);
         }
-        Latin1Converter::unlock();
     }
 }
+void
+AnalysisResult::addValidUtf8Text(const char* text, int32_t length) {
+    p->writeText(text, length);
+}
 AnalyzerConfiguration&
 AnalysisResult::config() const {
     return p->m_analyzerconfig;
@@ -299,6 +469,36 @@ void
 AnalysisResult::setEndAnalyzer(const StreamEndAnalyzer* ea) {
     p->m_endanalyzer = ea;
 }
+bool
+AnalysisResult::withinTimeBudget() {
+    if (p->m_truncated) return false;
+    if (!p->m_analyzerconfig.hasTimeBudget()) return true;
+    // use the smallest budget of this file and the files that contain it
+    int32_t budget = 0;
+    const AnalysisResult* root = this;
+    for (const AnalysisResult* r = this; r; r = r->p->m_parent) {
+        const StreamEndAnalyzer* ea = r->p->m_endanalyzer;
+        int32_t b = p->m_analyzerconfig.timeBudget((ea) ?ea->name() :"",
+            r->p->m_mimetype);
+        if (b > 0 && (budget == 0 || b < budget)) {
+            budget = b;
+        }
+        root = r;
+    }
+    if (budget == 0 || root->p->m_starttime == 0
+            || AnalyzerTimer::now(false) - root->p->m_starttime
+                < (int64_t)budget*1000) {
+        return true;
+    }
+    for (AnalysisResult* r = this; r; r = r->p->m_parent) {
+        r->p->m_truncated = true;
+    }
+    return false;
+}
+bool
+AnalysisResult::isTruncated() const {
+    return p->m_truncated;
+}
 string
 AnalysisResult::extension() const {
     string::size_type p1 = p->m_name.rfind('.');
@@ -314,20 +514,17 @@ AnalysisResult::addValue(const RegisteredField* field, const std::string& val) {
     if (!p->checkCardinality(field)) {
 	return;
     }
-    if (checkUtf8(val)) {
-        p->m_writer.addValue(this, field, val);
+    if (validateUtf8(val)) {
+        p->writeValue(field, val);
     } else {
-        Latin1Converter::lock();
-        char* d;
-        int32_t len = Latin1Converter::fromLatin1(d, val.c_str(),
-                                                    (int32_t)val.length());
-        if (len && checkUtf8(d, len)) {
-            p->m_writer.addValue(this, field, (const unsigned char*)d, len);
+        const char* d;
+        int32_t len = p->fromLatin1(d, val.c_str(), (int32_t)val.length());
+        if (len && validateUtf8(d, len)) {
+            p->writeValue(field, d, len);
         } else {
             fprintf(stderr, "'%s' is not a UTF8 or latin1 string\n",
                 val.c_str());
         }
-        Latin1Converter::unlock();
     }
 }
 void
@@ -337,70 +534,111 @@ AnalysisResult::addValue(const RegisteredField* field,
     if (!p->checkCardinality(field)) {
 	return;
     }
-    if (checkUtf8(data, length)) {
-        p->m_writer.addValue(this, field, (const unsigned char*)data, length);
+    if (validateUtf8(data, length)) {
+        p->writeValue(field, data, length);
     } else {
-        Latin1Converter::lock();
-        char* d;
-        int32_t len = Latin1Converter::fromLatin1(d, data, length);
-        if (len && checkUtf8(d, len)) {
-            p->m_writer.addValue(this, field, (const unsigned char*)d, len);
+        const char* d;
+        int32_t len = p->fromLatin1(d, data, length);
+        if (len && validateUtf8(d, len)) {
+            p->writeValue(field, d, len);
         } else {
             fprintf(stderr, "'%.*s' is not a UTF8 or latin1 string\n",
                 length, data);
         }
-        Latin1Converter::unlock();
     }
 }
 void
 AnalysisResult::addValue(const RegisteredField* field, int32_t value) {
     if (!p->checkCardinality(field))
 	return;
-    p->m_writer.addValue(this, field, value);
+    p->writeValue(field, value);
 }
 void
 AnalysisResult::addValue(const RegisteredField* field, uint32_t value) {
     if (!p->checkCardinality(field))
 	return;
-    p->m_writer.addValue(this, field, value);
+    p->writeValue(field, value);
 }
 void
 AnalysisResult::addValue(const RegisteredField* field, double value) {
     if (!p->checkCardinality(field))
 	return;
-    p->m_writer.addValue(this, field, value);
+    p->writeValue(field, value);
 }
 void
 AnalysisResult::addTriplet(const std::string& subject, const std::string& predicate,
         const std::string& object){
     p->m_writer.addTriplet(subject, predicate, object);
 }
+void
+AnalysisResult::addTriplet(const std::string& subject, uint32_t predicate,
+        const std::string& object) {
+    p->m_writer.addTriplet(this, subject, predicate, object);
+}
+void
+AnalysisResult::addTriplet(const std::string& subject, uint32_t predicate,
+        uint32_t object) {
+    p->m_writer.addTriplet(this, subject, predicate, object);
+}
+/**
+ * Write the lowest 5*@p n bits of @p v as @p n characters.
+ **/
+static char*
+appendUriBits(char* o, uint32_t v, int n) {
+    static const char digits[] = "abcdefghijklmnopqrstuvwxyz234567";
+    while (n--) {
+        *o++ = digits[v & 31];
+        v >>= 5;
+    }
+    return o;
+}
 std::string
 AnalysisResult::newAnonymousUri(){
-    std::string result;
-    result.resize(6);
-    result[0]=':';
-    for(int i=1; i<6; i++)
-      result[i]=(char)((rand() % 26) + 'a');
-    return result;
+    // all uris of a file are numbered by its top-level result
+    Private* r = p;
+    while (r->m_parent) {
+        r = r->m_parent->p;
+    }
+    // ':' followed by 20 bits of the process prefix, 30 bits of the serial
+    // of the file and 20 bits of the counter. At 15 characters the string
+    // fits in the inline buffer of common std::string implementations.
+    char uri[15];
+    uri[0] = ':';
+    char* o = appendUriBits(uri+1, AnonymousUriSerials::serials().prefix, 4);
+    o = appendUriBits(o, r->m_uriserial, 6);
+    appendUriBits(o, r->m_uricount++, 4);
+    return std::string(uri, 15);
 }
 bool
 AnalysisResult::Private::checkCardinality(const RegisteredField* field) {
-    std::map<const Strigi::RegisteredField*, int>::const_iterator i
-        = m_occurrences.find(field);
-    if (i != m_occurrences.end()) {
-	if (i->second >= field->properties().maxCardinality()
-                && field->properties().maxCardinality() >= 0) {
-	    fprintf(stderr, "%s hit the maxCardinality limit (%d)\n",
-		field->properties().name().c_str(),
-                    field->properties().maxCardinality());
-	    return false;
-	} else {
-	    m_occurrences[field]++;
-	}
-    } else {
-	m_occurrences[field] = 1;
+    const int max = field->properties().maxCardinality();
+    if (max < 0) {
+        // no limit, no need to count
+        return true;
+    }
+    const size_t id = field->id();
+    if (id >= m_occurrences.size()) {
+        // make room for all fields at once
+        size_t n = m_analyzerconfig.fieldRegister().fields().size();
+        m_occurrences.resize((n > id) ?n :id+1, 0);
     }
+    int& n = m_occurrences[id];
+    if (n > 0 && n >= max) {
+	fprintf(stderr, "%s hit the maxCardinality limit (%d)\n",
+	    field->properties().name().c_str(), max);
+	return false;
+    }
+    n++;
     return true;
 }
+int32_t
+AnalysisResult::Private::fromLatin1(const char*& out, const char* data,
+        int32_t len) {
+    if (len <= 0) return 0;
+    if (m_utf8.size() < 2*(size_t)len) {
+        m_utf8.resize(2*(size_t)len);
+    }
+    out = &m_utf8[0];
+    return latin1ToUtf8(&m_utf8[0], data, len);
+}
 
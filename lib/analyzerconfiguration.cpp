@@ -20,8 +20,10 @@
 #include <strigi/analyzerconfiguration.h>
 #include <strigi/strigiconfig.h>
 #include "strigi_fnmatch.h"
+#include "endanalyzerranking.h"
 #include <strigi/fieldproperties.h>
 #include <strigi/fieldpropertiesdb.h>
+#include <map>
 using namespace std;
 using namespace Strigi;
 
@@ -56,9 +58,27 @@ public:
     FieldRegister m_fieldregister;
 
     bool indexArchiveContents;
+    int prefetchDepth;
+    int64_t prefetchMemory;
+    int32_t prefetchSize;
+    int32_t prefetchWholeFileSize;
+    int32_t timeBudget;
+    int analyzerCacheDepth;
+    int64_t maximalTextLength;
+    bool adaptiveEndAnalyzerOrder;
+    bool memoryMapping;
+    EndAnalyzerRanking ranking;
+    std::map<std::string, int32_t> timeBudgets;
 
     AnalyzerConfigurationPrivate()
-        : indexArchiveContents( true ) {
+        : indexArchiveContents( true ), prefetchDepth(0),
+          prefetchMemory(32*1024*1024), prefetchSize(64*1024),
+          prefetchWholeFileSize(1024*1024), timeBudget(0),
+          analyzerCacheDepth(3), maximalTextLength(16*1024*1024),
+          adaptiveEndAnalyzerOrder(false), memoryMapping(false) {
+    }
+    static EndAnalyzerRanking& rankingOf(const AnalyzerConfiguration& c) {
+        return c.p->ranking;
     }
 };
 
@@ -115,6 +135,123 @@ void
 AnalyzerConfiguration::setIndexArchiveContents( bool b ) {
     p->indexArchiveContents = b;
 }
+void
+AnalyzerConfiguration::setAdaptiveEndAnalyzerOrder(bool adaptive) {
+    p->adaptiveEndAnalyzerOrder = adaptive;
+}
+bool
+AnalyzerConfiguration::adaptiveEndAnalyzerOrder() const {
+    return p->adaptiveEndAnalyzerOrder;
+}
+void
+AnalyzerConfiguration::setMemoryMapping(bool map) {
+    p->memoryMapping = map;
+}
+bool
+AnalyzerConfiguration::memoryMapping() const {
+    return p->memoryMapping;
+}
+bool
+AnalyzerConfiguration::saveEndAnalyzerOrder(const string& path) const {
+    return p->ranking.save(path);
+}
+bool
+AnalyzerConfiguration::loadEndAnalyzerOrder(const string& path) {
+    return p->ranking.load(path);
+}
+EndAnalyzerRanking&
+Strigi::endAnalyzerRanking(const AnalyzerConfiguration& config) {
+    return AnalyzerConfigurationPrivate::rankingOf(config);
+}
+int
+AnalyzerConfiguration::analyzerCacheDepth() const {
+    return p->analyzerCacheDepth;
+}
+void
+AnalyzerConfiguration::setAnalyzerCacheDepth(int depth) {
+    p->analyzerCacheDepth = depth;
+}
+int64_t
+AnalyzerConfiguration::maximalTextLength() const {
+    return p->maximalTextLength;
+}
+void
+AnalyzerConfiguration::setMaximalTextLength(int64_t bytes) {
+    p->maximalTextLength = bytes;
+}
+void
+AnalyzerConfiguration::setTimeBudget(int32_t ms) {
+    p->timeBudget = ms;
+}
+void
+AnalyzerConfiguration::setTimeBudget(const string& key, int32_t ms) {
+    if (ms > 0) {
+        p->timeBudgets[key] = ms;
+    } else {
+        p->timeBudgets.erase(key);
+    }
+}
+namespace {
+int32_t
+smallestBudget(int32_t a, int32_t b) {
+    return (a > 0 && (b <= 0 || a < b)) ?a :b;
+}
+}
+int32_t
+AnalyzerConfiguration::timeBudget(const string& endanalyzer,
+        const string& mimetype) const {
+    int32_t budget = p->timeBudget;
+    map<string, int32_t>::const_iterator i;
+    if (endanalyzer.size()) {
+        i = p->timeBudgets.find(endanalyzer);
+        if (i != p->timeBudgets.end()) {
+            budget = smallestBudget(i->second, budget);
+        }
+    }
+    if (mimetype.size()) {
+        i = p->timeBudgets.find(mimetype);
+        if (i != p->timeBudgets.end()) {
+            budget = smallestBudget(i->second, budget);
+        }
+    }
+    return (budget > 0) ?budget :0;
+}
+bool
+AnalyzerConfiguration::hasTimeBudget() const {
+    return p->timeBudget > 0 || p->timeBudgets.size();
+}
+int
+AnalyzerConfiguration::prefetchDepth() const {
+    return p->prefetchDepth;
+}
+void
+AnalyzerConfiguration::setPrefetchDepth(int depth) {
+    p->prefetchDepth = depth;
+}
+int64_t
+AnalyzerConfiguration::prefetchMemory() const {
+    return p->prefetchMemory;
+}
+void
+AnalyzerConfiguration::setPrefetchMemory(int64_t bytes) {
+    p->prefetchMemory = bytes;
+}
+int32_t
+AnalyzerConfiguration::prefetchSize() const {
+    return p->prefetchSize;
+}
+void
+AnalyzerConfiguration::setPrefetchSize(int32_t bytes) {
+    p->prefetchSize = bytes;
+}
+int32_t
+AnalyzerConfiguration::prefetchWholeFileSize() const {
+    return p->prefetchWholeFileSize;
+}
+void
+AnalyzerConfiguration::setPrefetchWholeFileSize(int32_t bytes) {
+    p->prefetchWholeFileSize = bytes;
+}
 bool
 AnalyzerConfiguration::indexDir(const char* path, const char* filename) const {
     vector<AnalyzerConfigurationPrivate::Pattern>::const_iterator i;
@@ -0,0 +1,268 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#include "analyzerfactoryset.h"
+#include <strigi/streamendanalyzer.h>
+#include <strigi/streamthroughanalyzer.h>
+#include <strigi/streamlineanalyzer.h>
+#include <strigi/streameventanalyzer.h>
+#include <strigi/streamsaxanalyzer.h>
+#include "endanalyzers/bz2endanalyzer.h"
+#include "endanalyzers/lzmaendanalyzer.h"
+#include "eventanalyzers/mimeeventanalyzer.h"
+#include "endanalyzers/bmpendanalyzer.h"
+#include "endanalyzers/textendanalyzer.h"
+#include "endanalyzers/tarendanalyzer.h"
+#include "endanalyzers/arendanalyzer.h"
+#include "endanalyzers/zipexeendanalyzer.h"
+#include "endanalyzers/odfendanalyzer.h"
+#include "endanalyzers/oleendanalyzer.h"
+#include "endanalyzers/rpmendanalyzer.h"
+#include "endanalyzers/cpioendanalyzer.h"
+#include "endanalyzers/pdfendanalyzer.h"
+#include "endanalyzers/sdfendanalyzer.h"
+#include "endanalyzers/pngendanalyzer.h"
+#include "endanalyzers/gzipendanalyzer.h"
+#include "lineanalyzers/m3ustreamanalyzer.h"
+#include "endanalyzers/mailendanalyzer.h"
+#include "endanalyzers/mpegendanalyzer.h"
+#include "endanalyzers/helperendanalyzer.h"
+#include "endanalyzers/id3endanalyzer.h"
+#include "throughanalyzers/oggthroughanalyzer.h"
+#include "endanalyzers/flacendanalyzer.h"
+#include <strigi/analyzerconfiguration.h>
+#include <strigi/strigi_thread.h>
+#include <strigi/indexpluginloader.h>
+#include "analyzerloader.h"
+#include "eventthroughanalyzer.h"
+#include "saxanalyzers/htmlsaxanalyzer.h"
+#include <cstdlib>
+#include <map>
+#include <config.h>
+
+using namespace std;
+using namespace Strigi;
+
+namespace {
+/**
+ * The sets that are in use, one per AnalyzerConfiguration.
+ **/
+class FactorySetRegistry {
+public:
+    map<const AnalyzerConfiguration*, AnalyzerFactorySet*> sets;
+    StrigiMutex mutex;
+
+    static FactorySetRegistry& registry() {
+        static FactorySetRegistry r;
+        return r;
+    }
+};
+}
+
+AnalyzerFactorySet*
+AnalyzerFactorySet::acquire(AnalyzerConfiguration& c) {
+    FactorySetRegistry& r = FactorySetRegistry::registry();
+    r.mutex.lock();
+    AnalyzerFactorySet*& set = r.sets[&c];
+    if (set == 0) {
+        set = new AnalyzerFactorySet(c);
+    }
+    set->refcount++;
+    r.mutex.unlock();
+    return set;
+}
+void
+AnalyzerFactorySet::release(AnalyzerFactorySet* set) {
+    FactorySetRegistry& r = FactorySetRegistry::registry();
+    r.mutex.lock();
+    if (--set->refcount == 0) {
+        r.sets.erase(&set->conf);
+        delete set;
+    }
+    r.mutex.unlock();
+}
+AnalyzerFactorySet::AnalyzerFactorySet(AnalyzerConfiguration& c)
+        :refcount(0), conf(c) {
+    moduleLoader = new AnalyzerLoader();
+    sizefield = c.fieldRegister().sizeField;
+    errorfield = c.fieldRegister().parseErrorField;
+
+    // load the plugins from the environment setting
+    const char* strigipluginpath(getenv("STRIGI_PLUGIN_PATH"));
+    if (strigipluginpath) {
+        vector<string> strigipluginpaths = getdirs(strigipluginpath);
+        for (uint i=0; i<strigipluginpaths.size(); ++i) {
+            moduleLoader->loadPlugins(strigipluginpaths[i].c_str());
+        }
+    } else {
+        moduleLoader->loadPlugins( LIBINSTALLDIR "/strigi");
+    }
+
+    initializeSaxFactories();
+    initializeLineFactories();
+    initializeEventFactories();
+    initializeThroughFactories();
+    initializeEndFactories();
+    signatures.build(endfactories);
+}
+AnalyzerFactorySet::~AnalyzerFactorySet() {
+    // delete all factories
+    vector<StreamThroughAnalyzerFactory*>::iterator ta;
+    for (ta = throughfactories.begin(); ta != throughfactories.end(); ++ta) {
+        delete *ta;
+    }
+    vector<StreamEndAnalyzerFactory*>::iterator ea;
+    for (ea = endfactories.begin(); ea != endfactories.end(); ++ea) {
+        delete *ea;
+    }
+    vector<StreamSaxAnalyzerFactory*>::iterator sa;
+    for (sa = saxfactories.begin(); sa != saxfactories.end(); ++sa) {
+        delete *sa;
+    }
+    vector<StreamLineAnalyzerFactory*>::iterator la;
+    for (la = linefactories.begin(); la != linefactories.end(); ++la) {
+        delete *la;
+    }
+    vector<StreamEventAnalyzerFactory*>::iterator da;
+    for (da = eventfactories.begin(); da != eventfactories.end(); ++da) {
+        delete *da;
+    }
+    delete moduleLoader;
+}
+void
+AnalyzerFactorySet::addFactory(StreamThroughAnalyzerFactory* f) {
+    f->registerFields(conf.fieldRegister());
+    if (conf.useFactory(f)) {
+        throughfactories.push_back(f);
+    } else {
+        delete f;
+    }
+}
+void
+AnalyzerFactorySet::initializeSaxFactories() {
+    list<StreamSaxAnalyzerFactory*> plugins
+        = moduleLoader->streamSaxAnalyzerFactories();
+    list<StreamSaxAnalyzerFactory*>::iterator i;
+    for (i = plugins.begin(); i != plugins.end(); ++i) {
+        addFactory(*i);
+    }
+    addFactory(new HtmlSaxAnalyzerFactory());
+}
+void
+AnalyzerFactorySet::initializeLineFactories() {
+    list<StreamLineAnalyzerFactory*> plugins
+        = moduleLoader->streamLineAnalyzerFactories();
+    list<StreamLineAnalyzerFactory*>::iterator i;
+    for (i = plugins.begin(); i != plugins.end(); ++i) {
+        addFactory(*i);
+    }
+//    addFactory(new OdfMimeTypeLineAnalyzerFactory());
+    addFactory(new M3uLineAnalyzerFactory());
+}
+void
+AnalyzerFactorySet::initializeEventFactories() {
+    list<StreamEventAnalyzerFactory*> plugins
+        = moduleLoader->streamEventAnalyzerFactories();
+    list<StreamEventAnalyzerFactory*>::iterator i;
+    addFactory(new MimeEventAnalyzerFactory());
+    for (i = plugins.begin(); i != plugins.end(); ++i) {
+        addFactory(*i);
+    }
+}
+void
+AnalyzerFactorySet::initializeThroughFactories() {
+    list<StreamThroughAnalyzerFactory*> plugins
+        = moduleLoader->streamThroughAnalyzerFactories();
+    list<StreamThroughAnalyzerFactory*>::iterator i;
+    for (i = plugins.begin(); i != plugins.end(); ++i) {
+        addFactory(*i);
+    }
+    addFactory(new OggThroughAnalyzerFactory());
+    addFactory(new EventThroughAnalyzerFactory(saxfactories, linefactories,
+        eventfactories));
+}
+void
+AnalyzerFactorySet::addFactory(StreamEventAnalyzerFactory* f) {
+    f->registerFields(conf.fieldRegister());
+    if (conf.useFactory(f)) {
+        eventfactories.push_back(f);
+    } else {
+        delete f;
+    }
+}
+void
+AnalyzerFactorySet::addFactory(StreamLineAnalyzerFactory* f) {
+    f->registerFields(conf.fieldRegister());
+    if (conf.useFactory(f)) {
+        linefactories.push_back(f);
+    } else {
+        delete f;
+    }
+}
+void
+AnalyzerFactorySet::addFactory(StreamSaxAnalyzerFactory* f) {
+    f->registerFields(conf.fieldRegister());
+    if (conf.useFactory(f)) {
+        saxfactories.push_back(f);
+    } else {
+        delete f;
+    }
+}
+void
+AnalyzerFactorySet::addFactory(StreamEndAnalyzerFactory* f) {
+    f->registerFields(conf.fieldRegister());
+    if (conf.useFactory(f)) {
+        endfactories.push_back(f);
+    } else {
+        delete f;
+    }
+}
+/**
+ * Instantiate factories for all analyzers.
+ **/
+void
+AnalyzerFactorySet::initializeEndFactories() {
+    list<StreamEndAnalyzerFactory*> plugins
+        = moduleLoader->streamEndAnalyzerFactories();
+    list<StreamEndAnalyzerFactory*>::iterator i;
+    for (i = plugins.begin(); i != plugins.end(); ++i) {
+        addFactory(*i);
+    }
+    addFactory(new Bz2EndAnalyzerFactory());
+    addFactory(new GZipEndAnalyzerFactory());
+    addFactory(new OleEndAnalyzerFactory());
+    addFactory(new TarEndAnalyzerFactory());
+    addFactory(new ArEndAnalyzerFactory());
+    addFactory(new MailEndAnalyzerFactory());
+//    addFactory(new MpegEndAnalyzerFactory()); //Xine fallback works so much better now
+    addFactory(new OdfEndAnalyzerFactory());
+    addFactory(new ZipEndAnalyzerFactory());
+    addFactory(new ZipExeEndAnalyzerFactory());
+    addFactory(new RpmEndAnalyzerFactory());
+    addFactory(new CpioEndAnalyzerFactory());
+    addFactory(new PngEndAnalyzerFactory());
+    addFactory(new BmpEndAnalyzerFactory());
+    addFactory(new FlacEndAnalyzerFactory());
+    addFactory(new ID3EndAnalyzerFactory());
+    addFactory(new PdfEndAnalyzerFactory());
+    addFactory(new SdfEndAnalyzerFactory());
+    addFactory(new LzmaEndAnalyzerFactory());
+#ifndef _MSC_VER
+    addFactory(new HelperEndAnalyzerFactory());
+#endif
+    addFactory(new TextEndAnalyzerFactory());
+}
@@ -0,0 +1,88 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef STRIGI_ANALYZERFACTORYSET_H
+#define STRIGI_ANALYZERFACTORYSET_H
+
+#include <strigi/strigiconfig.h>
+#include "signatureindex.h"
+#include <vector>
+
+namespace Strigi {
+
+class AnalyzerConfiguration;
+class AnalyzerLoader;
+class RegisteredField;
+class StreamThroughAnalyzerFactory;
+class StreamEndAnalyzerFactory;
+class StreamSaxAnalyzerFactory;
+class StreamLineAnalyzerFactory;
+class StreamEventAnalyzerFactory;
+
+/**
+ * The plugins, analyzer factories and field registrations for one
+ * AnalyzerConfiguration.
+ *
+ * Loading the plugins and creating the factories is expensive, so all
+ * StreamAnalyzers that use the same AnalyzerConfiguration share one
+ * AnalyzerFactorySet. After construction the set is not modified, so it can
+ * be used from several threads at the same time. Only the analyzer instances
+ * created by the factories are private to a StreamAnalyzer.
+ **/
+class AnalyzerFactorySet {
+private:
+    int refcount;
+    AnalyzerLoader* moduleLoader;
+
+    explicit AnalyzerFactorySet(AnalyzerConfiguration& c);
+    ~AnalyzerFactorySet();
+    void initializeThroughFactories();
+    void initializeEndFactories();
+    void initializeSaxFactories();
+    void initializeLineFactories();
+    void initializeEventFactories();
+    void addFactory(StreamThroughAnalyzerFactory* f);
+    void addFactory(StreamEndAnalyzerFactory* f);
+    void addFactory(StreamSaxAnalyzerFactory* f);
+    void addFactory(StreamLineAnalyzerFactory* f);
+    void addFactory(StreamEventAnalyzerFactory* f);
+public:
+    AnalyzerConfiguration& conf;
+    std::vector<StreamThroughAnalyzerFactory*> throughfactories;
+    std::vector<StreamEndAnalyzerFactory*> endfactories;
+    std::vector<StreamSaxAnalyzerFactory*> saxfactories;
+    std::vector<StreamLineAnalyzerFactory*> linefactories;
+    std::vector<StreamEventAnalyzerFactory*> eventfactories;
+    SignatureIndex signatures;
+    const RegisteredField* sizefield;
+    const RegisteredField* errorfield;
+
+    /**
+     * Get the set for @p c, creating it if no StreamAnalyzer uses it yet.
+     * Each call must be matched by a call to release().
+     **/
+    static AnalyzerFactorySet* acquire(AnalyzerConfiguration& c);
+    /**
+     * Release a set obtained with acquire(). The set is deleted when it is
+     * no longer used.
+     **/
+    static void release(AnalyzerFactorySet* set);
+};
+
+}
+
+#endif
@@ -0,0 +1,52 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <strigi/analyzerstatistics.h>
+
+using namespace Strigi;
+using namespace std;
+
+void
+AnalyzerStatistics::add(const AnalyzerStatistics& s) {
+    invocations += s.invocations;
+    headerHits += s.headerHits;
+    bytes += s.bytes;
+    wallTime += s.wallTime;
+    cpuTime += s.cpuTime;
+    failures += s.failures;
+    resets += s.resets;
+    budgetHits += s.budgetHits;
+}
+void
+AnalyzerStatistics::merge(vector<AnalyzerStatistics>& to,
+        const vector<AnalyzerStatistics>& from) {
+    vector<AnalyzerStatistics>::const_iterator f;
+    for (f = from.begin(); f != from.end(); ++f) {
+        vector<AnalyzerStatistics>::iterator t;
+        for (t = to.begin(); t != to.end(); ++t) {
+            if (t->type == f->type && t->depth == f->depth
+                    && t->name == f->name) {
+                break;
+            }
+        }
+        if (t == to.end()) {
+            to.push_back(*f);
+        } else {
+            t->add(*f);
+        }
+    }
+}
@@ -0,0 +1,61 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef STRIGI_ANALYZERTIMER_H
+#define STRIGI_ANALYZERTIMER_H
+
+#include <strigi/analyzerstatistics.h>
+#include <time.h>
+
+namespace Strigi {
+
+/**
+ * Measures the wall clock and thread cpu time between its construction and
+ * the call to addTo().
+ **/
+class AnalyzerTimer {
+private:
+    int64_t wall;
+    int64_t cpu;
+public:
+    // returns the wall clock time or, if @p thread is true, the cpu time of
+    // the current thread in microseconds
+    static int64_t now(bool thread) {
+#if defined(CLOCK_MONOTONIC) && defined(CLOCK_THREAD_CPUTIME_ID)
+        struct timespec t;
+        if (clock_gettime((thread) ?CLOCK_THREAD_CPUTIME_ID :CLOCK_MONOTONIC,
+                &t) != 0) {
+            return 0;
+        }
+        return (int64_t)t.tv_sec*1000000 + t.tv_nsec/1000;
+#else
+        return (thread) ?0 :(int64_t)time(0)*1000000;
+#endif
+    }
+    AnalyzerTimer() {
+        wall = now(false);
+        cpu = now(true);
+    }
+    void addTo(AnalyzerStatistics& s) const {
+        s.wallTime += now(false) - wall;
+        s.cpuTime += now(true) - cpu;
+    }
+};
+
+}
+
+#endif
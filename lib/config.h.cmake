@@ -12,6 +12,8 @@
 #cmakedefine HAVE_NDIR_H 1
 #cmakedefine HAVE_STDINT_H 1
 #cmakedefine HAVE_SYS_DIR_H 1
+#cmakedefine HAVE_SYS_INOTIFY_H 1
+#cmakedefine HAVE_SYS_MMAN_H 1
 #cmakedefine HAVE_SYS_NDIR_H 1
 #cmakedefine HAVE_SYS_SOCKET_H 1
 #cmakedefine HAVE_SYS_TYPES_H 1
@@ -26,16 +28,26 @@
 // functions
 //////////////////////////////
 #cmakedefine HAVE_FCHDIR 1
+#cmakedefine HAVE_FDOPENDIR 1
+#cmakedefine HAVE_FSTATAT 1
 #cmakedefine HAVE_GETTIMEOFDAY 1
+#cmakedefine HAVE_IO_URING 1
 #cmakedefine HAVE_ISBLANK 1
 #cmakedefine HAVE_MKSTEMP 1
 #cmakedefine HAVE_NANOSLEEP 1
+#cmakedefine HAVE_OPENAT 1
+#cmakedefine HAVE_POSIX_FADVISE 1
 #cmakedefine HAVE_SETENV 1
 #cmakedefine HAVE_STRCASECMP 1
 #cmakedefine HAVE_STRCASESTR 1
 #cmakedefine HAVE_STRLWR 1
 #cmakedefine HAVE_STRNCASECMP 1
 
+//////////////////////////////
+// structure members
+//////////////////////////////
+#cmakedefine HAVE_DIRENT_D_TYPE 1
+
 //////////////////////////////
 //thread stuff
 //////////////////////////////
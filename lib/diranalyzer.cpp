@@ -25,8 +25,12 @@
 #include <strigi/analysisresult.h>
 #include <strigi/analyzerconfiguration.h>
 #include <strigi/strigi_thread.h>
-#include <strigi/fileinputstream.h>
+#include "mmapinputstream.h"
+#include "fileprefetcher.h"
+#include "dirwatcher.h"
 #include <map>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <sys/stat.h>
 
@@ -42,6 +46,137 @@ using namespace std;
 # define S_ISREG(m)	(((m)&_IFMT) == _IFREG)
 #endif
 
+#ifdef _WIN32
+// windows does not have symbolic links, so stat() is fine
+#define strigi_lstat stat
+#else
+#define strigi_lstat lstat
+#endif
+
+
+namespace {
+
+typedef pair<string, time_t> IndexedFile;
+
+/**
+ * The files that IndexReader::listFiles() reports, grouped by directory.
+ *
+ * Keeping each path in its own string costs the path plus well over fifty
+ * bytes per file, which adds up to hundreds of megabytes for millions of
+ * files. Here each directory path is stored once and the file names are
+ * appended to one string pool, so a file costs its name plus 17 bytes.
+ **/
+class IndexedFiles : public IndexReader::FileHandler {
+private:
+    struct Entry {
+        uint32_t dir;
+        uint32_t name;
+        time_t mtime;
+    };
+    class EntryLess {
+    private:
+        const char* pool;
+    public:
+        explicit EntryLess(const char* p) :pool(p) {}
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.dir < b.dir || (a.dir == b.dir
+                && strcmp(pool + a.name, pool + b.name) < 0);
+        }
+    };
+    struct DirLess {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.dir < b.dir;
+        }
+        bool operator()(const Entry& a, uint32_t b) const {
+            return a.dir < b;
+        }
+        bool operator()(uint32_t a, const Entry& b) const {
+            return a < b.dir;
+        }
+    };
+    // the number of each directory that contains indexed files
+    map<string, uint32_t> dirs;
+    map<string, uint32_t>::const_iterator lastdir;
+    // the file names, each terminated by '\0'
+    string pool;
+    // sorted by directory and name after finish()
+    vector<Entry> entries;
+    bool overflow;
+public:
+    IndexedFiles() :lastdir(dirs.end()), overflow(false) {}
+    bool handleFile(const string& path, time_t mtime) {
+        string::size_type slash = path.rfind('/');
+        if (slash == string::npos) {
+            return true;
+        }
+        if (pool.size() + (path.length() - slash) > 0xffffffffu
+                || dirs.size() == 0xffffffffu) {
+            overflow = true;
+            return false;
+        }
+        // the listing is sorted, so most files are in the previous directory
+        if (lastdir == dirs.end() || lastdir->first.length() != slash
+                || path.compare(0, slash, lastdir->first) != 0) {
+            uint32_t n = (uint32_t)dirs.size();
+            lastdir = dirs.insert(make_pair(path.substr(0, slash), n)).first;
+        }
+        Entry e;
+        e.dir = lastdir->second;
+        e.name = (uint32_t)pool.size();
+        e.mtime = mtime;
+        pool.append(path, slash + 1, string::npos);
+        pool.push_back('\0');
+        entries.push_back(e);
+        return true;
+    }
+    /**
+     * Sort the entries. Returns false if the index holds too many files to
+     * store them here.
+     **/
+    bool finish() {
+        if (overflow) {
+            return false;
+        }
+        sort(entries.begin(), entries.end(), EntryLess(pool.c_str()));
+        return true;
+    }
+    /**
+     * Append the files in the directory @p dir to @p children, sorted by
+     * path.
+     **/
+    void children(const string& dir, vector<IndexedFile>& children) const {
+        map<string, uint32_t>::const_iterator d = dirs.find(dir);
+        if (d == dirs.end()) {
+            return;
+        }
+        pair<vector<Entry>::const_iterator, vector<Entry>::const_iterator> r
+            = equal_range(entries.begin(), entries.end(), d->second,
+                DirLess());
+        string path(dir);
+        path.append("/");
+        const string::size_type prefix = path.length();
+        for (; r.first != r.second; ++r.first) {
+            path.replace(prefix, string::npos, pool.c_str() + r.first->name);
+            children.push_back(make_pair(path, r.first->mtime));
+        }
+    }
+    void clear() {
+        map<string, uint32_t>().swap(dirs);
+        lastdir = dirs.end();
+        string().swap(pool);
+        vector<Entry>().swap(entries);
+        overflow = false;
+    }
+};
+
+struct PathLess {
+    bool operator()(const pair<string, struct stat>& a,
+            const pair<string, struct stat>& b) const {
+        return a.first < b.first;
+    }
+};
+
+}
 
 class DirAnalyzer::Private {
 public:
@@ -50,25 +185,50 @@ public:
     AnalyzerConfiguration& config;
     StreamAnalyzer analyzer;
     AnalysisCaller* caller;
+    // read-ahead stage, only used during analyzeDir() if enabled
+    FilePrefetcher* prefetcher;
+    // counters collected from the analyzers of finished threads
+    vector<AnalyzerStatistics> stats;
+    // all files in the index, only used during updateDirs() and only if
+    // the index can list its files
+    IndexedFiles indexedfiles;
+    bool haveindexedfiles;
+    // the changed files that watchDirs() hands to its threads
+    vector<pair<string, struct stat> > changed;
+    size_t nextchanged;
+    STRIGI_MUTEX_DEFINE(changedmutex);
 
     Private(IndexManager& m, AnalyzerConfiguration& c)
-            :dirlister(&c), manager(m), config(c), analyzer(c) {
+            :dirlister(&c), manager(m), config(c), analyzer(c),
+             prefetcher(0), haveindexedfiles(false), nextchanged(0) {
         analyzer.setIndexWriter(*manager.indexWriter());
+        STRIGI_MUTEX_INIT(&changedmutex);
     }
     ~Private() {
+        STRIGI_MUTEX_DESTROY(&changedmutex);
     }
     int analyzeDir(const string& dir, int nthreads, AnalysisCaller* caller,
         const string& lastToSkip);
     int updateDirs(const vector<string>& dir, int nthreads,
+        AnalysisCaller* caller, bool listindex = true);
+    int watchDirs(const vector<string>& dirs, int nthreads,
         AnalysisCaller* caller);
-    void analyze(StreamAnalyzer*);
-    void update(StreamAnalyzer*);
+    void indexChanged(const vector<StreamAnalyzer*>& analyzers);
+    void indexChanged(StreamAnalyzer*);
+    void analyze(StreamAnalyzer*, int worker);
+    void analyzePrefetched(StreamAnalyzer*);
+    void update(StreamAnalyzer*, int worker);
+    void loadIndexedFiles(IndexReader* reader);
+    void indexedChildren(const string& dir,
+        vector<IndexedFile>& children) const;
     int analyzeFile(const string& path, time_t mtime, bool realfile);
 };
 
 struct DA {
     StreamAnalyzer* streamanalyzer;
     DirAnalyzer::Private* diranalyzer;
+    // the number of the thread, used to pick its queue in the DirLister
+    int worker;
 };
 
 extern "C" // Linkage for functions passed to pthread_create matters
@@ -76,7 +236,7 @@ extern "C" // Linkage for functions passed to pthread_create matters
 void*
 analyzeInThread(void* d) {
     DA* a = static_cast<DA*>(d);
-    a->diranalyzer->analyze(a->streamanalyzer);
+    a->diranalyzer->analyze(a->streamanalyzer, a->worker);
     delete a;
     STRIGI_THREAD_EXIT(0);
     return 0; // Return bogus value
@@ -84,7 +244,15 @@ analyzeInThread(void* d) {
 void*
 updateInThread(void* d) {
     DA* a = static_cast<DA*>(d);
-    a->diranalyzer->update(a->streamanalyzer);
+    a->diranalyzer->update(a->streamanalyzer, a->worker);
+    delete a;
+    STRIGI_THREAD_EXIT(0);
+    return 0; // Return bogus value
+}
+void*
+indexChangedInThread(void* d) {
+    DA* a = static_cast<DA*>(d);
+    a->diranalyzer->indexChanged(a->streamanalyzer);
     delete a;
     STRIGI_THREAD_EXIT(0);
     return 0; // Return bogus value
@@ -103,7 +271,8 @@ DirAnalyzer::Private::analyzeFile(const string& path, time_t mtime,
     AnalysisResult analysisresult(path, mtime, *manager.indexWriter(),
         analyzer, "");
     if (realfile) {
-        InputStream* file = FileInputStream::open(path.c_str());
+        InputStream* file = MMapInputStream::open(path.c_str(),
+            config.memoryMapping());
         int r = analysisresult.index(file);
         delete file;
         return r;
@@ -112,12 +281,16 @@ DirAnalyzer::Private::analyzeFile(const string& path, time_t mtime,
     }
 }
 void
-DirAnalyzer::Private::analyze(StreamAnalyzer* analyzer) {
+DirAnalyzer::Private::analyze(StreamAnalyzer* analyzer, int worker) {
+    if (prefetcher) {
+        analyzePrefetched(analyzer);
+        return;
+    }
     IndexWriter& indexWriter = *manager.indexWriter();
     try {
         string parentpath;
         vector<pair<string, struct stat> > dirfiles;
-        int r = dirlister.nextDir(parentpath, dirfiles);
+        int r = dirlister.nextDir(worker, parentpath, dirfiles);
 
         while (r == 0 && (caller == 0 || caller->continueAnalysis())) {
             vector<pair<string, struct stat> >::const_iterator end
@@ -129,7 +302,8 @@ DirAnalyzer::Private::analyze(StreamAnalyzer* analyzer) {
                 AnalysisResult analysisresult(filepath, s.st_mtime,
                     indexWriter, *analyzer, parentpath);
                 if (S_ISREG(s.st_mode)) {
-                    InputStream* file = FileInputStream::open(filepath.c_str());
+                    InputStream* file = MMapInputStream::open(filepath.c_str(),
+                        config.memoryMapping());
                     analysisresult.index(file);
                     delete file;
                 } else {
@@ -137,43 +311,103 @@ DirAnalyzer::Private::analyze(StreamAnalyzer* analyzer) {
                 }
                 if (!config.indexMore()) return;
             }
-            r = dirlister.nextDir(parentpath, dirfiles);
+            r = dirlister.nextDir(worker, parentpath, dirfiles);
+        }
+    } catch(...) {
+        fprintf(stderr, "Unknown error\n");
+    }
+}
+/**
+ * Analyze the files that were opened and read ahead by the prefetcher.
+ **/
+void
+DirAnalyzer::Private::analyzePrefetched(StreamAnalyzer* analyzer) {
+    IndexWriter& indexWriter = *manager.indexWriter();
+    try {
+        FilePrefetcher::Entry* e = prefetcher->next();
+        while (e) {
+            AnalysisResult analysisresult(e->path, e->stat.st_mtime,
+                indexWriter, *analyzer, e->parentpath);
+            analysisresult.index(e->stream);
+            delete e;
+            if (!config.indexMore()) {
+                prefetcher->stop();
+                return;
+            }
+            e = prefetcher->next();
         }
     } catch(...) {
         fprintf(stderr, "Unknown error\n");
+        prefetcher->stop();
     }
 }
 void
-DirAnalyzer::Private::update(StreamAnalyzer* analyzer) {
+DirAnalyzer::Private::loadIndexedFiles(IndexReader* reader) {
+    indexedfiles.clear();
+    haveindexedfiles = reader->listFiles(indexedfiles)
+        && indexedfiles.finish();
+    if (!haveindexedfiles) {
+        indexedfiles.clear();
+    }
+}
+/**
+ * Find the files in the directory @p dir in the list of indexed files.
+ **/
+void
+DirAnalyzer::Private::indexedChildren(const string& dir,
+        vector<IndexedFile>& children) const {
+    indexedfiles.children(dir, children);
+}
+void
+DirAnalyzer::Private::update(StreamAnalyzer* analyzer, int worker) {
     IndexReader* reader = manager.indexReader();
     vector<pair<string, struct stat> > dirfiles;
-    map<string, time_t> dbdirfiles;
+    map<string, time_t> dbchildren;
+    vector<IndexedFile> dbdirfiles;
     vector<string> toDelete;
     vector<pair<string, struct stat> > toIndex;
     try {
         string path;
         // loop over all files that exist in the index
-        int r = dirlister.nextDir(path, dirfiles);
+        int r = dirlister.nextDir(worker, path, dirfiles);
         while (r >= 0 && (caller == 0 || caller->continueAnalysis())) {
             if (r < 0) {
                 continue;
             }
-            // get the files that are in the current database
-            reader->getChildren(path, dbdirfiles);
+            // get the files that are in the current database, sorted by path
+            dbdirfiles.clear();
+            if (haveindexedfiles) {
+                indexedChildren(path, dbdirfiles);
+            } else {
+                reader->getChildren(path, dbchildren);
+                dbdirfiles.assign(dbchildren.begin(), dbchildren.end());
+            }
 
-            // get all files in this directory
+            // walk through the files in this directory and the files in
+            // the database in the same order
+            sort(dirfiles.begin(), dirfiles.end(), PathLess());
+            vector<IndexedFile>::const_iterator j = dbdirfiles.begin();
+            vector<IndexedFile>::const_iterator dbend = dbdirfiles.end();
             vector<pair<string, struct stat> >::const_iterator end
                 = dirfiles.end();
-            map<string, time_t>::const_iterator dbend = dbdirfiles.end();
             for (vector<pair<string, struct stat> >::const_iterator i
                     = dirfiles.begin(); i != end; ++i) {
                 const string& filepath(i->first);
                 time_t mtime = i->second.st_mtime;
 
+                // files in the database that come before this file are not
+                // in the current directory and should be deleted
+                while (j != dbend && j->first < filepath) {
+                    toDelete.push_back(j->first);
+                    ++j;
+                }
+
                 // check if this file is new or not
-                map<string, time_t>::iterator j = dbdirfiles.find(filepath);
-                bool newfile = j == dbend;
+                bool newfile = j == dbend || j->first != filepath;
                 bool updatedfile = !newfile && j->second != mtime;
+                if (!newfile) {
+                    ++j;
+                }
 
                 if (newfile || (updatedfile && !S_ISDIR(i->second.st_mode))) {
                     // if the file has not yet been indexed or if the mtime has
@@ -181,18 +415,17 @@ DirAnalyzer::Private::update(StreamAnalyzer* analyzer) {
                     // if a directory has been updated, this will not change the index
                     // so the entry is not removed from the index, nor reindexed
                     toIndex.push_back(make_pair(filepath, i->second));
-                } else {
-                    // files left in dbdirfiles after this loop will be deleted from the
-                    // index. because this file has not changed, it should not be
-                    // removed from the index
-                    dbdirfiles.erase(j);
+                }
+                if (updatedfile && !S_ISDIR(i->second.st_mode)) {
+                    // the writers do not replace documents, so the old
+                    // version has to be removed first
+                    toDelete.push_back(filepath);
                 }
             }
-            // all the files left in dbdirfiles, are not in the current
-            // directory and should be deleted
-            for (map<string, time_t>::const_iterator i = dbdirfiles.begin();
-                    i != dbend; ++i) {
-                toDelete.push_back(i->first);
+            // the remaining files in the database are not in the current
+            // directory either
+            for (; j != dbend; ++j) {
+                toDelete.push_back(j->first);
             }
             if (toDelete.size() > 0) {
                 manager.indexWriter()->deleteEntries(toDelete);
@@ -204,7 +437,8 @@ DirAnalyzer::Private::update(StreamAnalyzer* analyzer) {
                 AnalysisResult analysisresult(i->first, i->second.st_mtime,
                     *manager.indexWriter(), *analyzer, path);
                 if (S_ISREG(i->second.st_mode)) {
-                    InputStream* file = FileInputStream::open(i->first.c_str());
+                    InputStream* file = MMapInputStream::open(i->first.c_str(),
+                        config.memoryMapping());
                     analysisresult.index(file);
                     delete file;
                 } else {
@@ -213,7 +447,7 @@ DirAnalyzer::Private::update(StreamAnalyzer* analyzer) {
             }
             toDelete.clear();
             toIndex.clear();
-            r = dirlister.nextDir(path, dirfiles);
+            r = dirlister.nextDir(worker, path, dirfiles);
         }
     } catch(...) {
         fprintf(stderr, "Unknown error\n");
@@ -269,19 +503,28 @@ DirAnalyzer::Private::analyzeDir(const string& dir, int nthreads,
         analyzers[i] = new StreamAnalyzer(config);
         analyzers[i]->setIndexWriter(*manager.indexWriter());
     }
+    if (config.prefetchDepth() > 0) {
+        prefetcher = new FilePrefetcher(dirlister, config, caller);
+        // two I/O threads are enough to keep a disk busy
+        prefetcher->start(2);
+    }
     vector<STRIGI_THREAD_TYPE> threads;
     threads.resize(nthreads-1);
     for (int i=1; i<nthreads; i++) {
         DA* da = new DA();
         da->diranalyzer = this;
         da->streamanalyzer = analyzers[i];
+        da->worker = i;
         STRIGI_THREAD_CREATE(&threads[i-1], analyzeInThread, da);
     }
-    analyze(analyzers[0]);
+    analyze(analyzers[0], 0);
     for (int i=1; i<nthreads; i++) {
         STRIGI_THREAD_JOIN(threads[i-1]);
+        AnalyzerStatistics::merge(stats, analyzers[i]->statistics());
         delete analyzers[i];
     }
+    delete prefetcher;
+    prefetcher = 0;
     manager.indexWriter()->commit();
     return 0;
 }
@@ -293,7 +536,7 @@ DirAnalyzer::updateDir(const string& dir, int nthreads, AnalysisCaller* caller){
 }
 int
 DirAnalyzer::Private::updateDirs(const vector<string>& dirs, int nthreads,
-        AnalysisCaller* c) {
+        AnalysisCaller* c, bool listindex) {
     IndexReader* reader = manager.indexReader();
     if (reader == 0) return -1;
     caller = c;
@@ -309,6 +552,12 @@ DirAnalyzer::Private::updateDirs(const vector<string>& dirs, int nthreads,
     vector<STRIGI_THREAD_TYPE> threads;
     threads.resize(nthreads-1);
 
+    // one pass over all files in the index is much cheaper than a query
+    // for each directory, unless only a few directories are updated
+    if (listindex) {
+        loadIndexedFiles(reader);
+    }
+
     // loop over all directories that should be updated
     for (vector<string>::const_iterator d =dirs.begin(); d != dirs.end(); ++d) {
         dirlister.startListing(removeTrailingSlash(*d));
@@ -316,17 +565,21 @@ DirAnalyzer::Private::updateDirs(const vector<string>& dirs, int nthreads,
             DA* da = new DA();
             da->diranalyzer = this;
             da->streamanalyzer = analyzers[i];
+            da->worker = i;
             STRIGI_THREAD_CREATE(&threads[i-1], updateInThread, da);
         }
-        update(analyzers[0]);
+        update(analyzers[0], 0);
         // wait until all threads have finished
         for (int i=1; i<nthreads; i++) {
             STRIGI_THREAD_JOIN(threads[i-1]);
         }
         dirlister.stopListing();
     }
+    indexedfiles.clear();
+    haveindexedfiles = false;
     // clean up the analyzers
     for (int i=1; i<nthreads; i++) {
+        AnalyzerStatistics::merge(stats, analyzers[i]->statistics());
         delete analyzers[i];
     }
 
@@ -343,8 +596,154 @@ DirAnalyzer::Private::updateDirs(const vector<string>& dirs, int nthreads,
 
     return 0;
 }
+/**
+ * Index the files in 'changed' with one thread per analyzer.
+ **/
+void
+DirAnalyzer::Private::indexChanged(const vector<StreamAnalyzer*>& analyzers) {
+    nextchanged = 0;
+    const int nthreads = (int)analyzers.size();
+    vector<STRIGI_THREAD_TYPE> threads;
+    threads.resize(nthreads-1);
+    for (int i=1; i<nthreads; i++) {
+        DA* da = new DA();
+        da->diranalyzer = this;
+        da->streamanalyzer = analyzers[i];
+        da->worker = i;
+        STRIGI_THREAD_CREATE(&threads[i-1], indexChangedInThread, da);
+    }
+    indexChanged(analyzers[0]);
+    for (int i=1; i<nthreads; i++) {
+        STRIGI_THREAD_JOIN(threads[i-1]);
+    }
+    changed.clear();
+}
+void
+DirAnalyzer::Private::indexChanged(StreamAnalyzer* analyzer) {
+    IndexWriter& indexWriter = *manager.indexWriter();
+    try {
+        while (true) {
+            STRIGI_MUTEX_LOCK(&changedmutex);
+            size_t n = nextchanged++;
+            STRIGI_MUTEX_UNLOCK(&changedmutex);
+            if (n >= changed.size()) return;
+            const string& filepath(changed[n].first);
+            const struct stat& s = changed[n].second;
+            AnalysisResult analysisresult(filepath, s.st_mtime, indexWriter,
+                *analyzer, filepath.substr(0, filepath.rfind('/')));
+            if (S_ISREG(s.st_mode)) {
+                InputStream* file = MMapInputStream::open(filepath.c_str(),
+                    config.memoryMapping());
+                analysisresult.index(file);
+                delete file;
+            } else {
+                analysisresult.index(0);
+            }
+        }
+    } catch(...) {
+        fprintf(stderr, "Unknown error\n");
+    }
+}
+int
+DirAnalyzer::Private::watchDirs(const vector<string>& dirs, int nthreads,
+        AnalysisCaller* c) {
+    IndexReader* reader = manager.indexReader();
+    if (reader == 0) return -1;
+    DirWatcher watcher(&config);
+    if (!watcher.available()) return -1;
+    // start watching before the first update, so that no change is missed
+    vector<string> roots;
+    for (vector<string>::const_iterator d =dirs.begin(); d != dirs.end(); ++d) {
+        roots.push_back(removeTrailingSlash(*d));
+        if (!watcher.watchTree(roots.back())) return -1;
+    }
+    int r = updateDirs(roots, nthreads, c);
+    if (r != 0) return r;
+
+    if (nthreads < 1) nthreads = 1;
+    vector<StreamAnalyzer*> analyzers(nthreads);
+    analyzers[0] = &analyzer;
+    for (int i=1; i<nthreads; ++i) {
+        analyzers[i] = new StreamAnalyzer(config);
+        analyzers[i]->setIndexWriter(*manager.indexWriter());
+    }
+    vector<string> paths;
+    vector<string> toDelete;
+    vector<string> newdirs;
+    while (caller == 0 || caller->continueAnalysis()) {
+        paths.clear();
+        if (!watcher.changes(1000, paths)) {
+            // changes were lost, so compare everything with the index again
+            for (vector<string>::const_iterator d = roots.begin();
+                    d != roots.end(); ++d) {
+                watcher.watchTree(*d);
+            }
+            updateDirs(roots, nthreads, c);
+            continue;
+        }
+        for (vector<string>::const_iterator i = paths.begin();
+                i != paths.end(); ++i) {
+            struct stat s;
+            if (strigi_lstat((i->size()) ?i->c_str() :"/", &s) == -1) {
+                // removing a directory from the index removes its contents
+                // too
+                watcher.unwatchTree(*i);
+                toDelete.push_back(*i);
+                continue;
+            }
+            const char* name = i->c_str() + i->rfind('/') + 1;
+            time_t indexedmtime = reader->mTime(*i);
+            if (S_ISDIR(s.st_mode)) {
+                if (!config.indexDir(i->c_str(), name)) continue;
+                // a directory that was created or moved here: its contents
+                // are compared with the index after it is watched
+                watcher.watchTree(*i);
+                newdirs.push_back(*i);
+                // the entry of a directory does not change with its contents
+                if (indexedmtime != 0) continue;
+            } else if (!config.indexFile(i->c_str(), name)
+                    || indexedmtime == s.st_mtime) {
+                continue;
+            } else if (indexedmtime != 0) {
+                // the writers do not replace documents, so the old version
+                // has to be removed first
+                toDelete.push_back(*i);
+            }
+            changed.push_back(make_pair(*i, s));
+        }
+        if (toDelete.size() > 0) {
+            manager.indexWriter()->deleteEntries(toDelete);
+            toDelete.clear();
+        }
+        if (changed.size() > 0) {
+            indexChanged(analyzers);
+        }
+        if (newdirs.size() > 0) {
+            updateDirs(newdirs, nthreads, c, false);
+            newdirs.clear();
+        } else if (paths.size() > 0) {
+            manager.indexWriter()->commit();
+        }
+    }
+    for (int i=1; i<nthreads; i++) {
+        AnalyzerStatistics::merge(stats, analyzers[i]->statistics());
+        delete analyzers[i];
+    }
+    return 0;
+}
+vector<AnalyzerStatistics>
+DirAnalyzer::statistics() const {
+    vector<AnalyzerStatistics> s(p->stats);
+    AnalyzerStatistics::merge(s, p->analyzer.statistics());
+    return s;
+}
 int
 DirAnalyzer::updateDirs(const vector<string>& dirs, int nthreads,
         AnalysisCaller* caller) {
     return p->updateDirs(dirs, nthreads, caller);
 }
+int
+DirAnalyzer::watchDirs(const vector<string>& dirs, int nthreads,
+        AnalysisCaller* caller) {
+    return p->watchDirs(dirs, nthreads, caller);
+}
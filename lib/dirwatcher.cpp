@@ -0,0 +1,259 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "dirwatcher.h"
+#include <strigi/filelister.h>
+#include <sys/stat.h>
+#ifdef HAVE_SYS_INOTIFY_H
+#include <sys/inotify.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <map>
+#endif
+
+using namespace Strigi;
+using namespace std;
+
+class DirWatcher::Private {
+public:
+    const AnalyzerConfiguration* const config;
+    const long quiet;
+#ifdef HAVE_SYS_INOTIFY_H
+    // the time of the first and of the last event of a path that has not
+    // been reported yet
+    struct Pending {
+        long first;
+        long last;
+    };
+    int fd;
+    // the directory of each watch and the watch of each directory
+    map<int, string> dirs;
+    map<string, int> watches;
+    map<string, Pending> pending;
+    // set when the kernel dropped events
+    bool overflow;
+    vector<char> buffer;
+
+    static long now();
+    bool addWatch(const string& dir);
+    void readEvents();
+    void handleEvent(const struct inotify_event* e, long t);
+#endif
+
+    Private(const AnalyzerConfiguration* c, int q);
+    ~Private();
+};
+
+#ifdef HAVE_SYS_INOTIFY_H
+namespace {
+const uint32_t watchmask = IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE
+    | IN_DELETE_SELF | IN_MODIFY | IN_MOVE_SELF | IN_MOVED_FROM | IN_MOVED_TO
+    | IN_DONT_FOLLOW | IN_ONLYDIR;
+}
+DirWatcher::Private::Private(const AnalyzerConfiguration* c, int q)
+        :config(c), quiet(q), overflow(false), buffer(65536) {
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+}
+DirWatcher::Private::~Private() {
+    if (fd != -1) {
+        ::close(fd);
+    }
+}
+long
+DirWatcher::Private::now() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec*1000 + t.tv_nsec/1000000;
+}
+bool
+DirWatcher::Private::addWatch(const string& dir) {
+    // the root directory is passed around as an empty string
+    int wd = inotify_add_watch(fd, (dir.size()) ?dir.c_str() :"/", watchmask);
+    if (wd == -1) {
+        // a directory that is gone or that cannot be read does not leave
+        // a gap: its parent reports changes to it
+        return errno != ENOSPC && errno != ENOMEM;
+    }
+    // a directory that was moved keeps its watch
+    map<int, string>::iterator i = dirs.find(wd);
+    if (i != dirs.end() && i->second != dir) {
+        watches.erase(i->second);
+    }
+    dirs[wd] = dir;
+    watches[dir] = wd;
+    return true;
+}
+void
+DirWatcher::Private::readEvents() {
+    const long t = now();
+    ssize_t n;
+    while ((n = ::read(fd, &buffer[0], buffer.size())) > 0) {
+        const char* b = &buffer[0];
+        const char* end = b + n;
+        while (b < end) {
+            const struct inotify_event* e
+                = reinterpret_cast<const struct inotify_event*>(b);
+            handleEvent(e, t);
+            b += sizeof(struct inotify_event) + e->len;
+        }
+    }
+}
+void
+DirWatcher::Private::handleEvent(const struct inotify_event* e, long t) {
+    if (e->mask & IN_Q_OVERFLOW) {
+        overflow = true;
+        return;
+    }
+    map<int, string>::iterator d = dirs.find(e->wd);
+    if (d == dirs.end()) {
+        return;
+    }
+    if (e->mask & IN_IGNORED) {
+        // the watch was removed because its directory is gone
+        map<string, int>::iterator w = watches.find(d->second);
+        if (w != watches.end() && w->second == e->wd) {
+            watches.erase(w);
+        }
+        dirs.erase(d);
+        return;
+    }
+    string path(d->second);
+    if (e->len) {
+        path.append("/");
+        path.append(e->name);
+    } else if (!(e->mask & (IN_DELETE_SELF | IN_MOVE_SELF))) {
+        // changes to the directory itself are only interesting if it
+        // disappears; the events for its entries come with their names
+        return;
+    }
+    // merge the events of a path, so it is only reported once
+    map<string, Pending>::iterator i = pending.find(path);
+    if (i == pending.end()) {
+        Pending& p = pending[path];
+        p.first = t;
+        p.last = t;
+    } else {
+        i->second.last = t;
+    }
+}
+#else
+DirWatcher::Private::Private(const AnalyzerConfiguration* c, int q)
+        :config(c), quiet(q) {
+}
+DirWatcher::Private::~Private() {
+}
+#endif
+
+DirWatcher::DirWatcher(const AnalyzerConfiguration* config, int quiet)
+        :p(new Private(config, quiet)) {
+}
+DirWatcher::~DirWatcher() {
+    delete p;
+}
+bool
+DirWatcher::available() const {
+#ifdef HAVE_SYS_INOTIFY_H
+    return p->fd != -1;
+#else
+    return false;
+#endif
+}
+bool
+DirWatcher::watchTree(const string& dir) {
+#ifdef HAVE_SYS_INOTIFY_H
+    if (p->fd == -1) return false;
+    bool complete = p->addWatch(dir);
+    DirLister lister(p->config);
+    lister.startListing(dir);
+    string parent;
+    vector<pair<string, struct stat> > entries;
+    while (lister.nextDir(parent, entries) >= 0) {
+        vector<pair<string, struct stat> >::const_iterator end = entries.end();
+        for (vector<pair<string, struct stat> >::const_iterator i
+                = entries.begin(); i != end; ++i) {
+            if (S_ISDIR(i->second.st_mode) && !p->addWatch(i->first)) {
+                complete = false;
+            }
+        }
+    }
+    lister.stopListing();
+    return complete;
+#else
+    return false;
+#endif
+}
+void
+DirWatcher::unwatchTree(const string& dir) {
+#ifdef HAVE_SYS_INOTIFY_H
+    const string prefix(dir + '/');
+    map<string, int>::iterator i = p->watches.lower_bound(dir);
+    while (i != p->watches.end() && (i->first == dir
+            || i->first.compare(0, prefix.length(), prefix) == 0)) {
+        inotify_rm_watch(p->fd, i->second);
+        p->dirs.erase(i->second);
+        p->watches.erase(i++);
+    }
+#endif
+}
+bool
+DirWatcher::changes(int timeout, vector<string>& paths) {
+#ifdef HAVE_SYS_INOTIFY_H
+    if (p->fd == -1) return true;
+    // a file that is written to all the time is still reported now and then
+    const long maxdelay = 15*p->quiet;
+    long t = Private::now();
+    // do not sleep past the moment that a pending path becomes quiet
+    map<string, Private::Pending>::iterator i;
+    for (i = p->pending.begin(); i != p->pending.end(); ++i) {
+        long due = min(i->second.last + p->quiet, i->second.first + maxdelay);
+        if (due - t < timeout) {
+            timeout = (due > t) ?(int)(due - t) :0;
+        }
+    }
+    struct pollfd pfd;
+    pfd.fd = p->fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, timeout) > 0) {
+        p->readEvents();
+    }
+    if (p->overflow) {
+        p->overflow = false;
+        p->pending.clear();
+        return false;
+    }
+    t = Private::now();
+    i = p->pending.begin();
+    while (i != p->pending.end()) {
+        if (t - i->second.last >= p->quiet
+                || t - i->second.first >= maxdelay) {
+            paths.push_back(i->first);
+            p->pending.erase(i++);
+        } else {
+            ++i;
+        }
+    }
+#endif
+    return true;
+}
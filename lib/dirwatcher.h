@@ -0,0 +1,78 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef STRIGI_DIRWATCHER_H
+#define STRIGI_DIRWATCHER_H
+
+#include <string>
+#include <vector>
+
+namespace Strigi {
+class AnalyzerConfiguration;
+
+/**
+ * Reports the files and directories that change below a set of watched
+ * directories.
+ *
+ * On Linux, each directory gets an inotify watch. The events for a path are
+ * merged and the path is only reported when it has had no events for a
+ * while, so a file that is still being written is analyzed once, after the
+ * writer is done.
+ *
+ * When the library was built without inotify or when the kernel refuses an
+ * inotify instance, available() returns false and the directories have to
+ * be rescanned instead.
+ *
+ * A DirWatcher must only be used by one thread at a time.
+ **/
+class DirWatcher {
+private:
+    class Private;
+    Private* p;
+public:
+    /**
+     * @param config decides which directories below a watched directory
+     *        are watched too
+     * @param quiet the number of milliseconds a path must be free of events
+     *        before it is reported
+     **/
+    explicit DirWatcher(const AnalyzerConfiguration* config, int quiet = 2000);
+    ~DirWatcher();
+    bool available() const;
+    /**
+     * Watch @p dir and all directories below it.
+     * @return false if not all directories could be watched, e.g. because
+     *         the limit on the number of watches was reached
+     **/
+    bool watchTree(const std::string& dir);
+    /**
+     * Stop watching @p dir and all directories below it.
+     **/
+    void unwatchTree(const std::string& dir);
+    /**
+     * Wait at most @p timeout milliseconds for changes and append the paths
+     * that changed and have been quiet long enough to @p paths. A path that
+     * is reported may have been created, changed, moved or deleted.
+     * @return false if the kernel dropped events, so changes were lost and
+     *         the watched directories have to be rescanned
+     **/
+    bool changes(int timeout, std::vector<std::string>& paths);
+};
+
+}
+
+#endif
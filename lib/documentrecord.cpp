@@ -0,0 +1,64 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <strigi/documentrecord.h>
+#include <cstring>
+
+using namespace Strigi;
+
+void
+DocumentRecord::append(const RegisteredField* field, Type type,
+        const char* data, uint32_t size) {
+    Entry e;
+    e.field = field;
+    e.type = type;
+    e.offset = (uint32_t)m_data.size();
+    e.size = size;
+    m_entries.push_back(e);
+    m_data.append(data, size);
+}
+void
+DocumentRecord::add(const RegisteredField* field, int32_t value) {
+    append(field, Int32, (const char*)&value, sizeof(value));
+}
+void
+DocumentRecord::add(const RegisteredField* field, uint32_t value) {
+    append(field, UInt32, (const char*)&value, sizeof(value));
+}
+void
+DocumentRecord::add(const RegisteredField* field, double value) {
+    append(field, Double, (const char*)&value, sizeof(value));
+}
+// the values are not aligned in the buffer, so they are copied out
+int32_t
+DocumentRecord::int32Value(const Entry& e) const {
+    int32_t v;
+    memcpy(&v, data(e), sizeof(v));
+    return v;
+}
+uint32_t
+DocumentRecord::uint32Value(const Entry& e) const {
+    uint32_t v;
+    memcpy(&v, data(e), sizeof(v));
+    return v;
+}
+double
+DocumentRecord::doubleValue(const Entry& e) const {
+    double v;
+    memcpy(&v, data(e), sizeof(v));
+    return v;
+}
@@ -0,0 +1,123 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#include "endanalyzerranking.h"
+#include <strigi/streamendanalyzer.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+using namespace Strigi;
+using namespace std;
+
+namespace {
+struct RankedFactory {
+    size_t index;
+    int priority;
+    double score;
+};
+bool
+operator<(const RankedFactory& a, const RankedFactory& b) {
+    if (a.priority != b.priority) {
+        return a.priority > b.priority;
+    }
+    return a.score > b.score;
+}
+}
+
+void
+EndAnalyzerRanking::sort(const string& bucket,
+        const vector<StreamEndAnalyzerFactory*>& factories,
+        vector<size_t>& order) {
+    vector<RankedFactory> ranked(order.size());
+    mutex.lock();
+    map<string, Bucket>::const_iterator b = buckets.find(bucket);
+    for (size_t i = 0; i < order.size(); ++i) {
+        const StreamEndAnalyzerFactory* f = factories[order[i]];
+        RankedFactory& r = ranked[i];
+        r.index = order[i];
+        r.priority = f->priority();
+        // analyzers without history get the neutral score 0.5
+        uint32_t claims = 0, successes = 0;
+        if (b != buckets.end()) {
+            Bucket::const_iterator c = b->second.find(f->name());
+            if (c != b->second.end()) {
+                claims = c->second.claims;
+                successes = c->second.successes;
+            }
+        }
+        r.score = (successes + 1.0) / (claims + 2.0);
+    }
+    mutex.unlock();
+    stable_sort(ranked.begin(), ranked.end());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = ranked[i].index;
+    }
+}
+void
+EndAnalyzerRanking::record(const string& bucket, const char* name,
+        bool success) {
+    mutex.lock();
+    Counts& c = buckets[bucket][name];
+    c.claims++;
+    if (success) {
+        c.successes++;
+    }
+    mutex.unlock();
+}
+bool
+EndAnalyzerRanking::save(const string& path) {
+    ofstream out(path.c_str());
+    if (!out) return false;
+    mutex.lock();
+    map<string, Bucket>::const_iterator b;
+    for (b = buckets.begin(); b != buckets.end(); ++b) {
+        // the file has one tab separated line per bucket and analyzer
+        if (b->first.find_first_of("\t\n") != string::npos) continue;
+        Bucket::const_iterator c;
+        for (c = b->second.begin(); c != b->second.end(); ++c) {
+            out << b->first << '\t' << c->first << '\t' << c->second.claims
+                << '\t' << c->second.successes << '\n';
+        }
+    }
+    mutex.unlock();
+    out.close();
+    return !out.fail();
+}
+bool
+EndAnalyzerRanking::load(const string& path) {
+    ifstream in(path.c_str());
+    if (!in) return false;
+    string line;
+    mutex.lock();
+    while (getline(in, line)) {
+        string::size_type t1 = line.find('\t');
+        string::size_type t2 = (t1 == string::npos)
+            ?t1 :line.find('\t', t1+1);
+        if (t2 == string::npos) continue;
+        uint32_t claims = 0, successes = 0;
+        if (sscanf(line.c_str()+t2+1, "%u\t%u", &claims, &successes) != 2
+                || successes > claims) {
+            continue;
+        }
+        Counts& c = buckets[line.substr(0, t1)][line.substr(t1+1, t2-t1-1)];
+        c.claims += claims;
+        c.successes += successes;
+    }
+    mutex.unlock();
+    return true;
+}
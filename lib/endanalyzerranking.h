@@ -0,0 +1,89 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef STRIGI_ENDANALYZERRANKING_H
+#define STRIGI_ENDANALYZERRANKING_H
+
+#include <strigi/strigiconfig.h>
+#include <strigi/strigi_thread.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Strigi {
+
+class AnalyzerConfiguration;
+class StreamEndAnalyzerFactory;
+
+/**
+ * Success counts of the end analyzers, used to try the analyzer that is most
+ * likely to succeed first.
+ *
+ * Streams are put in buckets, e.g. by the signatures they match, and for
+ * each bucket and analyzer the number of times the analyzer claimed a stream
+ * and the number of times it then analyzed the stream successfully are
+ * counted. The counts are kept by name so they can be saved and loaded
+ * across runs and plugin changes.
+ *
+ * One ranking is shared by all StreamAnalyzers of an AnalyzerConfiguration,
+ * so all functions are thread-safe.
+ **/
+class EndAnalyzerRanking {
+private:
+    struct Counts {
+        uint32_t claims;
+        uint32_t successes;
+        Counts() :claims(0), successes(0) {}
+    };
+    typedef std::map<std::string, Counts> Bucket;
+    std::map<std::string, Bucket> buckets;
+    StrigiMutex mutex;
+public:
+    /**
+     * Sort @p order, a list of indices into @p factories, so that the
+     * analyzers with the best success rate in @p bucket come first. The
+     * sort is stable and never moves an analyzer before one with a higher
+     * priority.
+     **/
+    void sort(const std::string& bucket,
+        const std::vector<StreamEndAnalyzerFactory*>& factories,
+        std::vector<size_t>& order);
+    /**
+     * Count a stream in @p bucket that was claimed by the analyzer
+     * @p name and record if the analysis succeeded.
+     **/
+    void record(const std::string& bucket, const char* name, bool success);
+    /**
+     * Write the counts to the file @p path.
+     * @return true on success
+     **/
+    bool save(const std::string& path);
+    /**
+     * Add the counts from the file @p path, which was written by save().
+     * @return true on success
+     **/
+    bool load(const std::string& path);
+};
+
+/**
+ * The ranking that the StreamAnalyzers of @p config share.
+ **/
+EndAnalyzerRanking& endAnalyzerRanking(const AnalyzerConfiguration& config);
+
+}
+
+#endif
@@ -47,6 +47,12 @@ BmpEndAnalyzerFactory::registerFields(FieldRegister& reg) {
     addField(heightField);
     addField(colorDepthField);
     addField(rdftypeField);
+    addSignature("BM", 2);
+    addSignature("BA", 2);
+    addSignature("CI", 2);
+    addSignature("CP", 2);
+    addSignature("IC", 2);
+    addSignature("PT", 2);
 }
 
 bool
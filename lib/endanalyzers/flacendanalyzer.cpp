@@ -109,6 +109,18 @@ FlacEndAnalyzerFactory::registerFields(FieldRegister& r) {
     fields["discnumber"] = r.registerField(discNumberPropertyName);
 
     typeField = r.typeField;
+
+    typeSymbol = r.registerSymbol(typePropertyName);
+    fullnameSymbol = r.registerSymbol(fullnamePropertyName);
+    titleSymbol = r.registerSymbol(titlePropertyName);
+    albumTrackCountSymbol = r.registerSymbol(albumTrackCountPropertyName);
+    albumGainSymbol = r.registerSymbol(albumGainPropertyName);
+    albumPeakGainSymbol = r.registerSymbol(albumPeakGainPropertyName);
+    albumArtistSymbol = r.registerSymbol(albumArtistPropertyName);
+    musicBrainzAlbumIDSymbol = r.registerSymbol(musicBrainzAlbumIDPropertyName);
+    albumClassSymbol = r.registerSymbol(albumClassName);
+    contactClassSymbol = r.registerSymbol(contactClassName);
+    addSignature("fLaC", 4);
 }
 
 bool
@@ -119,7 +131,7 @@ FlacEndAnalyzer::checkHeader(const char* header, int32_t headersize) const {
 
 inline
 void
-addStatement(AnalysisResult& indexable, string& subject, const string& predicate, const string& object) {
+addStatement(AnalysisResult& indexable, string& subject, uint32_t predicate, const string& object) {
   if (subject.empty())
     subject = indexable.newAnonymousUri();
   indexable.addTriplet(subject, predicate, object);
@@ -245,7 +257,7 @@ FlacEndAnalyzer::analyze(Strigi::AnalysisResult& indexable, Strigi::InputStream*
                     // the track number
                     indexable.addValue(iter->second, value.substr(0, pos));
                     // the track count
-                    addStatement(indexable, albumUri, albumTrackCountName, value.substr(pos+1));
+                    addStatement(indexable, albumUri, factory->albumTrackCountSymbol, value.substr(pos+1));
                 }
                 else {
                     if(name == "replaygain_track_gain")
@@ -259,32 +271,32 @@ FlacEndAnalyzer::analyze(Strigi::AnalysisResult& indexable, Strigi::InputStream*
                                           (int32_t)value.length());
 		    } else if(name=="albumartist") {
 			const string albumArtistUri( indexable.newAnonymousUri() );
-			addStatement(indexable, albumUri, albumArtistPropertyName, albumArtistUri);
-			indexable.addTriplet(albumArtistUri, typePropertyName, contactClassName);
-			indexable.addTriplet(albumArtistUri, fullnamePropertyName, value);			
+			addStatement(indexable, albumUri, factory->albumArtistSymbol, albumArtistUri);
+			indexable.addTriplet(albumArtistUri, factory->typeSymbol, factory->contactClassSymbol);
+			indexable.addTriplet(albumArtistUri, factory->fullnameSymbol, value);			
 		    } else if(name=="album") {
-			addStatement(indexable, albumUri, titlePropertyName, value);
+			addStatement(indexable, albumUri, factory->titleSymbol, value);
 		    } else if(name=="mbalbumid") {
-			addStatement(indexable, albumUri, musicBrainzAlbumIDPropertyName, value);
+			addStatement(indexable, albumUri, factory->musicBrainzAlbumIDSymbol, value);
 		    } else if(name=="trackcount" || name=="tracktotal") {
-			addStatement(indexable, albumUri, albumTrackCountPropertyName, value);
+			addStatement(indexable, albumUri, factory->albumTrackCountSymbol, value);
 		    } else if(name=="replaygain_album_gain") {
 			// the gain is often in the form "number dB", the appending "dB" must be removed
-			addStatement(indexable, albumUri, albumGainPropertyName, removeAlphabets(value));
+			addStatement(indexable, albumUri, factory->albumGainSymbol, removeAlphabets(value));
 		    } else if(name=="replaygain_album_peak") {
-			addStatement(indexable, albumUri, albumPeakGainPropertyName, removeAlphabets(value));
+			addStatement(indexable, albumUri, factory->albumPeakGainSymbol, removeAlphabets(value));
 		    } else if(name=="composer") {
 			const string composerUri( indexable.newAnonymousUri() );
 
 			indexable.addValue(factory->composerField, composerUri);
-			indexable.addTriplet(composerUri, typePropertyName, contactClassName);
-			indexable.addTriplet(composerUri, fullnamePropertyName, value);
+			indexable.addTriplet(composerUri, factory->typeSymbol, factory->contactClassSymbol);
+			indexable.addTriplet(composerUri, factory->fullnameSymbol, value);
 		    } else if(name=="publisher") {
 			const string publisherUri( indexable.newAnonymousUri() );
 
 			indexable.addValue(factory->publisherField, publisherUri);
-			indexable.addTriplet(publisherUri, typePropertyName, contactClassName);
-			indexable.addTriplet(publisherUri, fullnamePropertyName, value);
+			indexable.addTriplet(publisherUri, factory->typeSymbol, factory->contactClassSymbol);
+			indexable.addTriplet(publisherUri, factory->fullnameSymbol, value);
 		    } else if(name=="performer") {
                         performers.push_back(value);
                     }
@@ -318,8 +330,8 @@ FlacEndAnalyzer::analyze(Strigi::AnalysisResult& indexable, Strigi::InputStream*
                 const string artistUri( indexable.newAnonymousUri() );
 
                 indexable.addValue(artistField, artistUri);
-                indexable.addTriplet(artistUri, typePropertyName, contactClassName);
-                indexable.addTriplet(artistUri, fullnamePropertyName, *aIt);
+                indexable.addTriplet(artistUri, factory->typeSymbol, factory->contactClassSymbol);
+                indexable.addTriplet(artistUri, factory->fullnameSymbol, *aIt);
             }
         }
         if (performerField) {
@@ -329,14 +341,14 @@ FlacEndAnalyzer::analyze(Strigi::AnalysisResult& indexable, Strigi::InputStream*
                 const string performerUri( indexable.newAnonymousUri() );
 
                 indexable.addValue(performerField, performerUri);
-                indexable.addTriplet(performerUri, typePropertyName, contactClassName);
-                indexable.addTriplet(performerUri, fullnamePropertyName, *pIt);
+                indexable.addTriplet(performerUri, factory->typeSymbol, factory->contactClassSymbol);
+                indexable.addTriplet(performerUri, factory->fullnameSymbol, *pIt);
             }
         }
 
 	if(!albumUri.empty()) {
 	  indexable.addValue(factory->albumField, albumUri);
-	  indexable.addTriplet(albumUri, typePropertyName, albumClassName);
+	  indexable.addTriplet(albumUri, factory->typeSymbol, factory->albumClassSymbol);
 	}
 
 	// set the "codec" value
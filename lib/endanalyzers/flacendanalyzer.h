@@ -59,6 +59,17 @@ private:
     const Strigi::RegisteredField* codecField;
     const Strigi::RegisteredField* typeField;
 
+    uint32_t typeSymbol;
+    uint32_t fullnameSymbol;
+    uint32_t titleSymbol;
+    uint32_t albumTrackCountSymbol;
+    uint32_t albumGainSymbol;
+    uint32_t albumPeakGainSymbol;
+    uint32_t albumArtistSymbol;
+    uint32_t musicBrainzAlbumIDSymbol;
+    uint32_t albumClassSymbol;
+    uint32_t contactClassSymbol;
+
     const char* name() const {
         return "FlacEndAnalyzer";
     }
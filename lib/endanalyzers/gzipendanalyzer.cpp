@@ -32,6 +32,7 @@ void
 GZipEndAnalyzerFactory::registerFields(FieldRegister& reg) {
     typeField = reg.typeField;
     addField(typeField);
+    addSignature("\x1f\x8b", 2);
 }
 
 bool
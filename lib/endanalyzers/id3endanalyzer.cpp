@@ -311,11 +311,20 @@ ID3EndAnalyzerFactory::registerFields(FieldRegister& r) {
     samplerateField	= r.registerField(NFO "sampleRate");
     codecField		= r.registerField(NFO "codec");
     channelsField	= r.registerField(NFO "channels");
+
+    typeSymbol		= r.registerSymbol(typePropertyName);
+    fullnameSymbol	= r.registerSymbol(fullnamePropertyName);
+    titleSymbol		= r.registerSymbol(titlePropertyName);
+    albumArtistSymbol	= r.registerSymbol(albumArtistPropertyName);
+    albumTrackCountSymbol = r.registerSymbol(albumTrackCountPropertyName);
+    discCountSymbol	= r.registerSymbol(discCountPropertyName);
+    albumClassSymbol	= r.registerSymbol(albumClassName);
+    contactClassSymbol	= r.registerSymbol(contactClassName);
 }
 
 inline
 void
-addStatement(AnalysisResult &indexable, string& subject, const string& predicate, const string& object) {
+addStatement(AnalysisResult &indexable, string& subject, uint32_t predicate, const string& object) {
     if (subject.empty())
 	subject = indexable.newAnonymousUri();
     indexable.addTriplet(subject, predicate, object);
@@ -548,25 +557,25 @@ ID3EndAnalyzer::analyze(Strigi::AnalysisResult& indexable, Strigi::InputStream*
 		    string performerUri = indexable.newAnonymousUri();
 
 		    indexable.addValue(factory->performerField, performerUri);
-		    indexable.addTriplet(performerUri, typePropertyName, contactClassName);
-		    indexable.addTriplet(performerUri, fullnamePropertyName, value);
+		    indexable.addTriplet(performerUri, factory->typeSymbol, factory->contactClassSymbol);
+		    indexable.addTriplet(performerUri, factory->fullnameSymbol, value);
 		    found_artist = true;
 		} else if (strncmp("TPE2", p, 4) == 0) {
 		    const string albumArtistUri( indexable.newAnonymousUri() );
 
-		    addStatement(indexable, albumUri, albumArtistPropertyName, albumArtistUri);
-		    indexable.addTriplet(albumArtistUri, typePropertyName, contactClassName);
-		    indexable.addTriplet(albumArtistUri, fullnamePropertyName, value);
+		    addStatement(indexable, albumUri, factory->albumArtistSymbol, albumArtistUri);
+		    indexable.addTriplet(albumArtistUri, factory->typeSymbol, factory->contactClassSymbol);
+		    indexable.addTriplet(albumArtistUri, factory->fullnameSymbol, value);
 		} else if ((strncmp("TPUB", p, 4) == 0) ||
 			    (strncmp("TENC", p, 4) == 0)) {
 		    string publisherUri = indexable.newAnonymousUri();
 
 		    indexable.addValue(factory->publisherField, publisherUri);
-		    indexable.addTriplet(publisherUri, typePropertyName, contactClassName);
-		    indexable.addTriplet(publisherUri, fullnamePropertyName, value);
+		    indexable.addTriplet(publisherUri, factory->typeSymbol, factory->contactClassSymbol);
+		    indexable.addTriplet(publisherUri, factory->fullnameSymbol, value);
 		} else if ((strncmp("TALB", p, 4) == 0) ||
 			    (strncmp("TOAL", p, 4) == 0)) {
-		    addStatement(indexable, albumUri, titlePropertyName, value);
+		    addStatement(indexable, albumUri, factory->titleSymbol, value);
 		    found_album = true;
 		} else if (strncmp("TCON", p, 4) == 0) {
 		    genre_number_parser p(value);
@@ -586,14 +595,14 @@ ID3EndAnalyzer::analyze(Strigi::AnalysisResult& indexable, Strigi::InputStream*
 		    string lyricistUri = indexable.newAnonymousUri();
 
 		    indexable.addValue(factory->lyricistField, lyricistUri);
-		    indexable.addTriplet(lyricistUri, typePropertyName, contactClassName);
-		    indexable.addTriplet(lyricistUri, fullnamePropertyName, value);
+		    indexable.addTriplet(lyricistUri, factory->typeSymbol, factory->contactClassSymbol);
+		    indexable.addTriplet(lyricistUri, factory->fullnameSymbol, value);
 		} else if (strncmp("TCOM", p, 4) == 0) {
 		    string composerUri = indexable.newAnonymousUri();
 
 		    indexable.addValue(factory->composerField, composerUri);
-		    indexable.addTriplet(composerUri, typePropertyName, contactClassName);
-		    indexable.addTriplet(composerUri, fullnamePropertyName, value);
+		    indexable.addTriplet(composerUri, factory->typeSymbol, factory->contactClassSymbol);
+		    indexable.addTriplet(composerUri, factory->fullnameSymbol, value);
 		} else if (strncmp("TRCK", p, 4) == 0) {
 		    istringstream ins(value);
 		    int tnum;
@@ -607,7 +616,7 @@ ID3EndAnalyzer::analyze(Strigi::AnalysisResult& indexable, Strigi::InputStream*
 			if (!ins.fail()) {
 			    ostringstream outs;
 			    outs << tcount;
-			    addStatement(indexable, albumUri, albumTrackCountPropertyName, outs.str());
+			    addStatement(indexable, albumUri, factory->albumTrackCountSymbol, outs.str());
 			}
 		    }
 		} else if (strncmp("TPOS", p, 4) == 0) {
@@ -622,7 +631,7 @@ ID3EndAnalyzer::analyze(Strigi::AnalysisResult& indexable, Strigi::InputStream*
 			if (!ins.fail()) {
 			    ostringstream outs;
 			    outs << dcount;
-			    addStatement(indexable, albumUri, discCountPropertyName, outs.str());
+			    addStatement(indexable, albumUri, factory->discCountSymbol, outs.str());
 			}
 		    }
 		}
@@ -671,11 +680,11 @@ ID3EndAnalyzer::analyze(Strigi::AnalysisResult& indexable, Strigi::InputStream*
 	    if (!found_artist && extract_and_trim(buf, 33, 30, s)) {
                 const string performerUri = indexable.newAnonymousUri();
                 indexable.addValue(factory->performerField, performerUri);
-                indexable.addTriplet(performerUri, typePropertyName, contactClassName);
-                indexable.addTriplet(performerUri, fullnamePropertyName, s);
+                indexable.addTriplet(performerUri, factory->typeSymbol, factory->contactClassSymbol);
+                indexable.addTriplet(performerUri, factory->fullnameSymbol, s);
             }
 	    if (!found_album && extract_and_trim(buf, 63, 30, s))
-		addStatement(indexable, albumUri, titlePropertyName, s);
+		addStatement(indexable, albumUri, factory->titleSymbol, s);
 	    if (!found_year && extract_and_trim(buf, 93, 4, s))
 		indexable.addValue(factory->createdField, s);
 	    if (!found_comment && extract_and_trim(buf, 97, 30, s)) {
@@ -691,7 +700,7 @@ ID3EndAnalyzer::analyze(Strigi::AnalysisResult& indexable, Strigi::InputStream*
 
     if(!albumUri.empty()) {
 	indexable.addValue(factory->albumField, albumUri);
-	indexable.addTriplet(albumUri, typePropertyName, albumClassName);
+	indexable.addTriplet(albumUri, factory->typeSymbol, factory->albumClassSymbol);
     }
 
     if (found_tag)
@@ -63,6 +63,15 @@ private:
     const Strigi::RegisteredField* codecField;
     const Strigi::RegisteredField* channelsField;
 
+    uint32_t typeSymbol;
+    uint32_t fullnameSymbol;
+    uint32_t titleSymbol;
+    uint32_t albumArtistSymbol;
+    uint32_t albumTrackCountSymbol;
+    uint32_t discCountSymbol;
+    uint32_t albumClassSymbol;
+    uint32_t contactClassSymbol;
+
     const char* name() const {
         return "ID3EndAnalyzer";
     }
@@ -19,6 +19,7 @@
  */
 #include "mailendanalyzer.h"
 #include "analysisresult.h"
+#include "analyzerconfiguration.h"
 #include <strigi/strigiconfig.h>
 #include <strigi/mailinputstream.h>
 #include <strigi/encodinginputstream.h>
@@ -81,6 +82,15 @@ MailEndAnalyzerFactory::registerFields(FieldRegister& r) {
     emailInReplyToField = r.registerField(emailInReplyToFieldName);
     typeField = r.typeField;
 
+    typeSymbol = r.registerSymbol(typeFieldName);
+    fullnameSymbol = r.registerSymbol(fullnameFieldName);
+    hasEmailAddressSymbol = r.registerSymbol(hasEmailAddressFieldName);
+    emailAddressSymbol = r.registerSymbol(emailAddressFieldName);
+    contentidSymbol = r.registerSymbol(contentidFieldName);
+    emailClassSymbol = r.registerSymbol(emailClassName);
+    contactClassSymbol = r.registerSymbol(contactClassName);
+    emailAddressClassSymbol = r.registerSymbol(emailAddressClassName);
+
     addField(titleField);
     addField(contenttypeField);
     addField(fromField);
@@ -123,8 +133,9 @@ splitAddress(const string& addr, string& name, string& email) {
     email = addr;
   }
 }
-string 
-processAddress(Strigi::AnalysisResult& idx, const string& address) {
+string
+MailEndAnalyzer::processAddress(Strigi::AnalysisResult& idx,
+        const string& address) const {
     string uri(idx.newAnonymousUri());
     string cmUri;
     string name, email;
@@ -132,12 +143,13 @@ processAddress(Strigi::AnalysisResult& idx, const string& address) {
     splitAddress(address, name, email);
     cmUri = "mailto:" + email;
 
-    idx.addTriplet(uri, typeFieldName, contactClassName);
+    idx.addTriplet(uri, factory->typeSymbol, factory->contactClassSymbol);
     if (name.size())
-	idx.addTriplet(uri, fullnameFieldName, name);
-    idx.addTriplet(uri, hasEmailAddressFieldName, cmUri);
-    idx.addTriplet(cmUri, typeFieldName, emailAddressClassName);
-    idx.addTriplet(cmUri, emailAddressFieldName, email);
+	idx.addTriplet(uri, factory->fullnameSymbol, name);
+    idx.addTriplet(uri, factory->hasEmailAddressSymbol, cmUri);
+    idx.addTriplet(cmUri, factory->typeSymbol,
+        factory->emailAddressClassSymbol);
+    idx.addTriplet(cmUri, factory->emailAddressSymbol, email);
     
     return uri;
 }
@@ -170,14 +182,14 @@ MailEndAnalyzer::analyze(AnalysisResult& idx, InputStream* in) {
     if (mail.inreplyto().length() > 0) {
 	string uri(idx.newAnonymousUri());
         idx.addValue(factory->emailInReplyToField, uri);
-	idx.addTriplet(uri, typeFieldName, emailClassName);
-	idx.addTriplet(uri, contentidFieldName, mail.inreplyto());
+	idx.addTriplet(uri, factory->typeSymbol, factory->emailClassSymbol);
+	idx.addTriplet(uri, factory->contentidSymbol, mail.inreplyto());
     }
     if (mail.references().length() > 0) {
 	string uri(idx.newAnonymousUri());
 	idx.addValue(factory->contentlinkField, uri);
-	idx.addTriplet(uri, typeFieldName, emailClassName);
-	idx.addTriplet(uri, contentidFieldName, mail.references());
+	idx.addTriplet(uri, factory->typeSymbol, factory->emailClassSymbol);
+	idx.addTriplet(uri, factory->contentidSymbol, mail.references());
     }
     if (s != 0) {
         TextEndAnalyzer tea;
@@ -191,6 +203,10 @@ MailEndAnalyzer::analyze(AnalysisResult& idx, InputStream* in) {
     s = mail.nextEntry();
     int n = 1;
     while (s) {
+        // check if the analysis has been aborted
+        if (!idx.config().indexMore() || !idx.withinTimeBudget()) {
+            return 0;
+        }
         std::string file;
         if (mail.entryInfo().filename.length() == 0) {
             file = (char)(n+'1');
@@ -27,6 +27,9 @@ class MailEndAnalyzerFactory;
 class MailEndAnalyzer : public Strigi::StreamEndAnalyzer {
 private:
     const MailEndAnalyzerFactory* factory;
+
+    std::string processAddress(Strigi::AnalysisResult& idx,
+        const std::string& address) const;
 public:
     explicit MailEndAnalyzer(const MailEndAnalyzerFactory* f) :factory(f) {}
     bool checkHeader(const char* header, int32_t headersize) const;
@@ -49,6 +52,16 @@ private:
 
     const Strigi::RegisteredField* typeField;
 
+    // symbols for the triplets
+    uint32_t typeSymbol;
+    uint32_t fullnameSymbol;
+    uint32_t hasEmailAddressSymbol;
+    uint32_t emailAddressSymbol;
+    uint32_t contentidSymbol;
+    uint32_t emailClassSymbol;
+    uint32_t contactClassSymbol;
+    uint32_t emailAddressClassSymbol;
+
 public:
     const char* name() const {
         return "MailEndAnalyzer";
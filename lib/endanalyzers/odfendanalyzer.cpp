@@ -40,6 +40,9 @@ This was tested on Koffice 2.* and OpenOffice 3.*
 void
 OdfEndAnalyzerFactory::registerFields(FieldRegister& reg) {
     typeField = reg.typeField;
+    addSignature("mimetypeapplication/vnd.oasis.opendocument.", 43, 30);
+    // odf files are zip files too and should not be taken by the zip analyzer
+    setPriority(1);
 }
 
 bool
@@ -27,6 +27,7 @@
 #include <strigi/oleinputstream.h>
 #include <strigi/subinputstream.h>
 #include <strigi/analysisresult.h>
+#include <strigi/analyzerconfiguration.h>
 #include <strigi/fieldtypes.h>
 #include <strigi/textutils.h>
 #include <sstream>
@@ -383,6 +384,10 @@ OleEndAnalyzer::analyze(AnalysisResult& ar, InputStream* in) {
 	return -1;
     }
     while (s) {
+        // check if the analysis has been aborted
+        if (!ar.config().indexMore() || !ar.withinTimeBudget()) {
+            return 0;
+        }
         string name = ole.entryInfo().filename;
         if (name.size()) {
             char first = name[0];
@@ -32,6 +32,7 @@ void
 PdfEndAnalyzerFactory::registerFields(FieldRegister& reg) {
     typeField = reg.typeField;
     addField(typeField);
+    addSignature("%PDF-1.", 7);
 }
 
 PdfEndAnalyzer::PdfEndAnalyzer(const PdfEndAnalyzerFactory* f) :factory(f) {
@@ -40,6 +41,10 @@ PdfEndAnalyzer::PdfEndAnalyzer(const PdfEndAnalyzerFactory* f) :factory(f) {
 }
 StreamStatus
 PdfEndAnalyzer::handle(InputStream* s) {
+    if (!analysisresult->withinTimeBudget()) {
+        parser.stop();
+        return Eof;
+    }
     ostringstream str;
     str << n++;
     char r = analysisresult->indexChild(str.str(), analysisresult->mTime(), s);
@@ -49,6 +54,10 @@ PdfEndAnalyzer::handle(InputStream* s) {
 }
 StreamStatus
 PdfEndAnalyzer::handle(const std::string& s) {
+    if (!analysisresult->withinTimeBudget()) {
+        parser.stop();
+        return Eof;
+    }
     analysisresult->addText(s.c_str(), (uint32_t)s.length());
     return Ok;
 }
@@ -118,6 +118,7 @@ PngEndAnalyzerFactory::registerFields(FieldRegister& reg) {
     addField(sourceField);
     addField(commentField);
     addField(typeField);
+    addSignature("\x89PNG\r\n\x1a\n", 8);
 }
 
 PngEndAnalyzer::PngEndAnalyzer(const PngEndAnalyzerFactory* f) :factory(f) {
@@ -57,7 +57,7 @@ TarEndAnalyzer::staticAnalyze(AnalysisResult& idx,
                 return 0;
             }
             // check if the analysis has been aborted
-            if (!idx.config().indexMore()) {
+            if (!idx.config().indexMore() || !idx.withinTimeBudget()) {
                 return 0;
             }
             idx.indexChild(tar.entryInfo().filename, tar.entryInfo().mtime, s);
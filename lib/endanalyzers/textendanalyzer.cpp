@@ -18,6 +18,7 @@
  * Boston, MA 02110-1301, USA.
  */
 #include "textendanalyzer.h"
+#include "../utf8validator.h"
 #include <strigi/strigiconfig.h>
 #include <strigi/streamanalyzer.h>
 #include <strigi/inputstreamreader.h>
@@ -29,12 +30,14 @@ using namespace std;
 
 void
 TextEndAnalyzerFactory::registerFields(FieldRegister& reg) {
+    // plain text is the fallback when no other analyzer applies
+    setPriority(-1);
 }
 
 bool
 TextEndAnalyzer::checkHeader(const char* header, int32_t headersize) const {
     char nb;
-    const char* last = checkUtf8(header, headersize, nb);
+    const char* last = validateUtf8(header, headersize, nb);
     return last == 0 || nb != 0;
 }
 
@@ -51,13 +54,13 @@ TextEndAnalyzer::analyze(AnalysisResult& idx, InputStream* in) {
     signed char retval = -1;
     if (nread > 0) {
         char nb;
-        const char* last = checkUtf8(b, nread, nb);
+        const char* last = validateUtf8(b, nread, nb);
         if (last == 0) {
             retval = 0;
-            idx.addText(b, nread);
+            idx.addValidUtf8Text(b, nread);
         } else if (nb) {
             retval = 0;
-            idx.addText(b, (uint32_t)(last-b));
+            idx.addValidUtf8Text(b, (int32_t)(last-b));
         }
     }
     if (in->status() == Error) {
@@ -56,7 +56,7 @@ ZipEndAnalyzer::analyze(AnalysisResult& idx, InputStream* in) {
                 return 0;
             }
             // check if the analysis has been aborted
-            if (!idx.config().indexMore()) {
+            if (!idx.config().indexMore() || !idx.withinTimeBudget()) {
                 return 0;
             }
             idx.indexChild(zip.entryInfo().filename, zip.entryInfo().mtime, s);
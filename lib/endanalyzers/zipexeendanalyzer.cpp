@@ -30,6 +30,7 @@ void
 ZipExeEndAnalyzerFactory::registerFields(FieldRegister& reg) {
     mimetypefield = reg.mimetypeField;
     typeField = reg.typeField;
+    addSignature("MZ\x90\0", 4);
 }
 
 bool
@@ -22,12 +22,20 @@
 #include <strigi/streameventanalyzer.h>
 #include "saxeventanalyzer.h"
 #include "lineeventanalyzer.h"
+#include "analyzertimer.h"
 #include <strigi/streamlineanalyzer.h>
 #include <iostream>
 
 using namespace std;
 using namespace Strigi;
 
+EventThroughAnalyzer::EventThroughAnalyzer(vector<StreamEventAnalyzer*>& e)
+        : event(e), stats(e.size()), datastream(0), result(0), ready(true) {
+    for (uint i = 0; i < event.size(); ++i) {
+        stats[i].name = event[i]->name();
+        stats[i].type = AnalyzerStatistics::Event;
+    }
+}
 EventThroughAnalyzer::~EventThroughAnalyzer() {
     if (datastream) {
         delete datastream;
@@ -52,7 +60,9 @@ EventThroughAnalyzer::connectInputStream(InputStream* in) {
         datastream = new DataEventInputStream(in, *this);
         ready = false;
         vector<StreamEventAnalyzer*>::iterator i;
-        for (i = event.begin(); i != event.end(); ++i) {
+        vector<AnalyzerStatistics>::iterator s = stats.begin();
+        for (i = event.begin(); i != event.end(); ++i, ++s) {
+            s->invocations++;
             (*i)->startAnalysis(result);
         }
     }
@@ -66,9 +76,13 @@ bool
 EventThroughAnalyzer::handleData(const char* data, uint32_t size) {
     if (ready) return false;
     vector<StreamEventAnalyzer*>::iterator i;
+    vector<AnalyzerStatistics>::iterator s = stats.begin();
     bool more = false;
-    for (i = event.begin(); i != event.end(); ++i) {
+    for (i = event.begin(); i != event.end(); ++i, ++s) {
+        AnalyzerTimer timer;
         (*i)->handleData(data, size);
+        timer.addTo(*s);
+        s->bytes += size;
         more = more || !(*i)->isReadyWithStream();
         //if (!(*i)->isReadyWithStream()) {
         //     cerr << "hungry analyzer: " << (*i)->name() << endl;
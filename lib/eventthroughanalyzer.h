@@ -24,6 +24,7 @@
 #include <strigi/strigiconfig.h>
 #include <strigi/dataeventinputstream.h>
 #include <strigi/streamthroughanalyzer.h>
+#include <strigi/analyzerstatistics.h>
 #include <vector>
 
 namespace Strigi {
@@ -39,6 +40,7 @@ class EventThroughAnalyzer : public StreamThroughAnalyzer,
         public DataEventHandler {
 private:
     std::vector<StreamEventAnalyzer*> event;
+    std::vector<AnalyzerStatistics> stats;
     DataEventInputStream* datastream;
     AnalysisResult* result;
     bool ready;
@@ -50,9 +52,14 @@ private:
     void handleEnd();
     const char* name() const { return "EventThroughAnalyzer"; }
 public:
-    explicit EventThroughAnalyzer(std::vector<StreamEventAnalyzer*>& e)
-            : event(e), datastream(0), result(0), ready(true){}
+    explicit EventThroughAnalyzer(std::vector<StreamEventAnalyzer*>& e);
     ~EventThroughAnalyzer();
+    /**
+     * Counters for the event analyzers, in the same order as the analyzers.
+     **/
+    const std::vector<AnalyzerStatistics>& statistics() const {
+        return stats;
+    }
 };
 class EventThroughAnalyzerFactory : public StreamThroughAnalyzerFactory {
     std::vector<StreamSaxAnalyzerFactory*>& saxfactories;
@@ -29,7 +29,7 @@ using namespace std;
 RegisteredField::RegisteredField(const string& k, const string& t, int m,
         const RegisteredField* p)
         : m_key(k), m_type(t), m_maxoccurs(m), m_parent(p), m_writerdata(0),
-	  m_properties(FieldPropertiesDb::db().properties(k)) {
+	  m_properties(FieldPropertiesDb::db().properties(k)), m_id(-1) {
 }
 
 RegisteredField::RegisteredField(const string& fieldname):
@@ -38,7 +38,8 @@ RegisteredField::RegisteredField(const string& fieldname):
     m_maxoccurs(FieldPropertiesDb::db().properties(fieldname).maxCardinality()), // obsolete - is never used
     m_parent(0), // obsolete - is never used
     m_writerdata(0),
-    m_properties(FieldPropertiesDb::db().properties(fieldname)) {
+    m_properties(FieldPropertiesDb::db().properties(fieldname)),
+    m_id(-1) {
 }
 
 const string FieldRegister::floatType = "float";
@@ -93,6 +94,17 @@ FieldRegister::registerField(const string& fieldname,
     // in exchange, properties loaded from fieldproperties database are used
     return registerField(fieldname);
 }
+uint32_t
+FieldRegister::registerSymbol(const string& uri) {
+    map<string, uint32_t>::const_iterator i = m_symbolids.find(uri);
+    if (i != m_symbolids.end()) {
+        return i->second;
+    }
+    uint32_t id = (uint32_t)m_symbols.size();
+    m_symbols.push_back(uri);
+    m_symbolids[uri] = id;
+    return id;
+}
 const RegisteredField*
 FieldRegister::registerField(const string& fieldname) {
     map<string, RegisteredField*>::iterator i = m_fields.find(fieldname);
@@ -111,6 +123,7 @@ FieldRegister::registerField(const string& fieldname) {
             FieldPropertiesDb::db().addField(fieldname);
         }
         RegisteredField* f = new RegisteredField(fieldname);
+        f->m_id = (int)m_fields.size();
         m_fields[fieldname] = f;
         return f;
     } else {
@@ -19,12 +19,15 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
 #include <strigi/filelister.h>
 #include <strigi/strigiconfig.h>
 #include <strigi/strigi_thread.h>
 #include <strigi/analyzerconfiguration.h>
-#include <set>
-#include <list>
+#include <deque>
 #include <iostream>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -37,6 +40,14 @@
 #endif
 #include <errno.h>
 
+#if defined(HAVE_OPENAT) && defined(HAVE_FSTATAT) && defined(HAVE_FDOPENDIR)
+// open and stat the entries relative to the file descriptor of their
+// directory instead of resolving the complete path each time
+#define STRIGI_DIR_FD
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #ifdef _WIN32
 // windows does not have symbolic links, so stat() is fine
 #define strigi_lstat stat
@@ -78,22 +89,81 @@ namespace
 
         return temp;
     }
+
+    enum EntryType { UnknownEntry, DirEntry, FileEntry, OtherEntry };
+
+    /**
+     * The type of a directory entry as far as readdir() tells it. Calling
+     * stat() is only needed for UnknownEntry.
+     **/
+    EntryType entryType(const struct dirent* entry) {
+#ifdef HAVE_DIRENT_D_TYPE
+        switch (entry->d_type) {
+        case DT_DIR:
+            return DirEntry;
+        case DT_REG:
+            return FileEntry;
+        case DT_UNKNOWN:
+            return UnknownEntry;
+        default:
+            return OtherEntry;
+        }
+#else
+        return UnknownEntry;
+#endif
+    }
+    EntryType entryType(const struct stat& s) {
+        if (S_ISDIR(s.st_mode)) return DirEntry;
+        if (S_ISREG(s.st_mode)) return FileEntry;
+        return OtherEntry;
+    }
+    bool isDotOrDotDot(const char* name) {
+        return name[0] == '.'
+            && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+    }
+    /**
+     * lstat() the entry @p name of the open directory @p dir. @p path is
+     * the complete path of the entry.
+     **/
+    int statEntry(DIR* dir, const string& path, const char* name,
+            struct stat& s) {
+#ifdef STRIGI_DIR_FD
+        return fstatat(dirfd(dir), name, &s, AT_SYMLINK_NOFOLLOW);
+#else
+        return strigi_lstat(path.c_str(), &s);
+#endif
+    }
+    /**
+     * Open the subdirectory @p name of the open directory @p dir. @p path
+     * is the complete path of the subdirectory.
+     **/
+    DIR* openSubDir(DIR* dir, const string& path, const char* name) {
+#ifdef STRIGI_DIR_FD
+        int fd = openat(dirfd(dir), name,
+            O_RDONLY | O_DIRECTORY | O_NOFOLLOW);
+        if (fd == -1) {
+            return 0;
+        }
+        DIR* d = fdopendir(fd);
+        if (d == 0) {
+            close(fd);
+        }
+        return d;
+#else
+        return opendir(path.c_str());
+#endif
+    }
 }
 
 class FileLister::Private {
 public:
-    char path[10000];
+    string path;
     STRIGI_MUTEX_DEFINE(mutex);
-    DIR** dirs;
-    DIR** dirsEnd;
-    DIR** curDir;
-    string::size_type* len;
-    string::size_type* lenEnd;
-    string::size_type* curLen;
+    // the stack of open directories and the lengths of their paths
+    vector<DIR*> dirs;
+    vector<string::size_type> lens;
     time_t mtime;
-    struct dirent* subdir;
     struct stat dirstat;
-    set<string> listedDirs;
     const AnalyzerConfiguration* const config;
 
     Private(const AnalyzerConfiguration* ic);
@@ -103,106 +173,94 @@ public:
         STRIGI_MUTEX_LOCK(&mutex);
         r = nextFile();
         if (r > 0) {
-            p.assign(path, r);
+            p.assign(path, 0, r);
             time = mtime;
         }
         STRIGI_MUTEX_UNLOCK(&mutex);
         return r;
     }
     void startListing(const std::string&);
+    void closeDirs();
     int nextFile();
 };
 FileLister::Private::Private(
             const AnalyzerConfiguration* ic) :
         config(ic) {
     STRIGI_MUTEX_INIT(&mutex);
-    int nOpenDirs = 100;
-    dirs = (DIR**)malloc(sizeof(DIR*)*nOpenDirs);
-    dirsEnd = dirs + nOpenDirs;
-    len = (string::size_type*)malloc(sizeof(string::size_type)*nOpenDirs);
-    lenEnd = len + nOpenDirs;
-    curDir = dirs - 1;
 }
 void
 FileLister::Private::startListing(const string& dir){
-    listedDirs.clear();
-    curDir = dirs;
-    curLen = len;
-    string::size_type len = dir.length();
-    *curLen = len;
-    strcpy(path, dir.c_str());
-    if (len) {
-        if (path[len-1] != '/') {
-            path[len++] = '/';
-            path[len] = 0;
-            *curLen = len;
+    closeDirs();
+    path.assign(dir);
+    if (path.length()) {
+        if (path[path.length()-1] != '/') {
+            path.append("/");
         }
-        DIR* d = opendir(path);
+        DIR* d = opendir(path.c_str());
         if (d) {
-            *curDir = d;
-            listedDirs.insert (path);
-        } else {
-            curDir--;
+            dirs.push_back(d);
+            lens.push_back(path.length());
         }
-    } else {
-        curDir--;
     }
 }
-FileLister::Private::~Private() {
-    while (curDir >= dirs) {
-        if (*curDir) {
-            closedir(*curDir);
-        }
-        curDir--;
+void
+FileLister::Private::closeDirs() {
+    for (size_t i = 0; i < dirs.size(); ++i) {
+        closedir(dirs[i]);
     }
-    free(dirs);
-    free(len);
+    dirs.clear();
+    lens.clear();
+}
+FileLister::Private::~Private() {
+    closeDirs();
     STRIGI_MUTEX_DESTROY(&mutex);
 }
 int
 FileLister::Private::nextFile() {
-
-    while (curDir >= dirs) {
-        DIR* dir = *curDir;
-        string::size_type l = *curLen;
-        subdir = readdir(dir);
+    while (!dirs.empty()) {
+        DIR* dir = dirs.back();
+        string::size_type l = lens.back();
+        struct dirent* subdir = readdir(dir);
         while (subdir) {
             // skip the directories '.' and '..'
-            char c1 = subdir->d_name[0];
-            if (c1 == '.') {
-                char c2 = subdir->d_name[1];
-                if (c2 == '.' || c2 == '\0') {
-                    subdir = readdir(dir);
-                    continue;
-                }
+            const char* name = subdir->d_name;
+            if (isDotOrDotDot(name)) {
+                subdir = readdir(dir);
+                continue;
             }
-            strcpy(path + l, subdir->d_name);
-            string::size_type sl = l + strlen(subdir->d_name);
-            if (strigi_lstat(path, &dirstat) == 0) {
-                if (S_ISREG(dirstat.st_mode)) {
-                    if (config == 0 || config->indexFile(path, path+l)) {
-                        mtime = dirstat.st_mtime;
-                        return (int)sl;
-                    }
-                } else if (dirstat.st_mode & S_IFDIR && (config == 0
-                        || config->indexDir(path, path+l))) {
+            path.resize(l);
+            path.append(name);
+            // only call stat when readdir() does not know the type or when
+            // the mtime of a file is needed
+            EntryType type = entryType(subdir);
+            bool stated = false;
+            if (type == UnknownEntry) {
+                stated = statEntry(dir, path, name, dirstat) == 0;
+                type = (stated) ?entryType(dirstat) :OtherEntry;
+            }
+            if (type == FileEntry) {
+                if ((config == 0 || config->indexFile(path.c_str(),
+                            path.c_str()+l))
+                        && (stated || statEntry(dir, path, name, dirstat) == 0)) {
                     mtime = dirstat.st_mtime;
-                    strcpy(this->path+sl, "/");
-                    DIR* d = opendir(path);
-                    if (d) {
-                        curDir++;
-                        curLen++;
-                        dir = *curDir = d;
-                        l = *curLen = sl+1;
-                        listedDirs.insert ( path);
-                    }
+                    return (int)path.length();
+                }
+            } else if (type == DirEntry && (config == 0
+                    || config->indexDir(path.c_str(), path.c_str()+l))) {
+                path.append("/");
+                DIR* d = openSubDir(dir, path, name);
+                if (d) {
+                    dirs.push_back(d);
+                    lens.push_back(path.length());
+                    dir = d;
+                    l = path.length();
                 }
             }
             subdir = readdir(dir);
         }
         closedir(dir);
-        curDir--;
-        curLen--;
+        dirs.pop_back();
+        lens.pop_back();
     }
     return -1;
 }
@@ -225,7 +283,7 @@ FileLister::nextFile(const char*& path, time_t& time) {
     int r = p->nextFile();
     if (r >= 0) {
         time = p->mtime;
-        path = p->path;
+        path = p->path.c_str();
     }
     return r;
 }
@@ -237,64 +295,134 @@ FileLister::skipTillAfter(const std::string& lastToSkip) {
     }
 }
 
+namespace {
+// the number of work queues of a DirLister, workers with a higher number
+// share a queue
+const int nqueues = 64;
+}
+
+/**
+ * The directories that still have to be listed are spread over a number of
+ * queues. A worker takes directories from the back of its own queue and,
+ * when that is empty, steals from the front of the queues of the others.
+ * The subdirectories that a worker finds are added to its own queue, so a
+ * worker usually descends into the directories it has just listed.
+ *
+ * No lock is held while the filesystem is read. The shared mutex only
+ * guards the number of pending directories, which tells the workers whether
+ * they should wait for more work or stop.
+ **/
 class DirLister::Private {
 public:
+    struct Queue {
+        StrigiMutex mutex;
+        deque<string> paths;
+    };
+    Queue queues[nqueues];
     STRIGI_MUTEX_DEFINE(mutex);
-    list<string> todoPaths;
+    STRIGI_COND_DEFINE(workavailable);
+    // the number of directories that are queued or being listed
+    int pending;
+    // incremented whenever directories are added to a queue
+    unsigned int generation;
+    int waiting;
     const AnalyzerConfiguration* const config;
 
-    Private(const AnalyzerConfiguration* ic) :config(ic) {}
-    int nextDir(std::string& path,
+    Private(const AnalyzerConfiguration* ic)
+            :pending(0), generation(0), waiting(0), config(ic) {}
+    void push(int worker, const vector<string>& paths);
+    bool take(int worker, string& path);
+    void clear();
+    int listDir(const string& path,
+        std::vector<std::pair<std::string, struct stat> >& dirs,
+        vector<string>& subdirs);
+    int nextDir(int worker, std::string& path,
         std::vector<std::pair<std::string, struct stat> >& dirs);
 };
 
 DirLister::DirLister(const AnalyzerConfiguration* ic)
     : p(new Private(ic)) {
     STRIGI_MUTEX_INIT(&p->mutex);
+    STRIGI_COND_INIT(&p->workavailable);
 }
 DirLister::~DirLister() {
+    STRIGI_COND_DESTROY(&p->workavailable);
     STRIGI_MUTEX_DESTROY(&p->mutex);
     delete p;
 }
 void
 DirLister::startListing(const string& dir) {
+    vector<string> paths(1, dir);
     STRIGI_MUTEX_LOCK(&p->mutex);
-    p->todoPaths.push_back(dir);
+    p->pending++;
     STRIGI_MUTEX_UNLOCK(&p->mutex);
+    p->push(0, paths);
 }
 void
 DirLister::stopListing() {
-    STRIGI_MUTEX_LOCK(&p->mutex);
-    p->todoPaths.clear();
-    STRIGI_MUTEX_UNLOCK(&p->mutex);
+    p->clear();
 }
-int
-DirLister::Private::nextDir(std::string& path,
-        std::vector<std::pair<std::string, struct stat> >& dirs) {
-    string entryname;
-    string entrypath;
-    size_t entrypathlength;
-    // check if there are more directories to work on
-    // open the directory
+void
+DirLister::Private::push(int worker, const vector<string>& paths) {
+    Queue& q = queues[worker % nqueues];
+    q.mutex.lock();
+    q.paths.insert(q.paths.end(), paths.begin(), paths.end());
+    q.mutex.unlock();
     STRIGI_MUTEX_LOCK(&mutex);
-    if (todoPaths.empty()) {
-        STRIGI_MUTEX_UNLOCK(&mutex);
-        return -1;
+    generation++;
+    if (waiting) {
+        STRIGI_COND_BROADCAST(&workavailable);
     }
-    path.assign(todoPaths.front());
-    todoPaths.pop_front();
-    // Only unlock of the todo list is not empty.
-    // If the list is empty, other threads must wait for this thread to populate
-    // the list.
-    bool mutexLocked = true;
-    if (!todoPaths.empty()) {
-        STRIGI_MUTEX_UNLOCK(&mutex);
-        mutexLocked = false;
+    STRIGI_MUTEX_UNLOCK(&mutex);
+}
+bool
+DirLister::Private::take(int worker, string& path) {
+    const int own = worker % nqueues;
+    Queue& q = queues[own];
+    q.mutex.lock();
+    if (!q.paths.empty()) {
+        path.assign(q.paths.back());
+        q.paths.pop_back();
+        q.mutex.unlock();
+        return true;
+    }
+    q.mutex.unlock();
+    for (int i = 1; i < nqueues; ++i) {
+        Queue& v = queues[(own + i) % nqueues];
+        v.mutex.lock();
+        if (!v.paths.empty()) {
+            path.assign(v.paths.front());
+            v.paths.pop_front();
+            v.mutex.unlock();
+            return true;
+        }
+        v.mutex.unlock();
+    }
+    return false;
+}
+void
+DirLister::Private::clear() {
+    int removed = 0;
+    for (int i = 0; i < nqueues; ++i) {
+        queues[i].mutex.lock();
+        removed += (int)queues[i].paths.size();
+        queues[i].paths.clear();
+        queues[i].mutex.unlock();
     }
+    STRIGI_MUTEX_LOCK(&mutex);
+    pending -= removed;
+    STRIGI_COND_BROADCAST(&workavailable);
+    STRIGI_MUTEX_UNLOCK(&mutex);
+}
+int
+DirLister::Private::listDir(const string& path,
+        std::vector<std::pair<std::string, struct stat> >& dirs,
+        vector<string>& subdirs) {
+    string entrypath;
+    size_t entrypathlength;
     entrypathlength = path.length()+1;
     entrypath.assign(path);
     entrypath.append("/");
-    dirs.clear();
     DIR* dir;
     if (path.size()) {
         dir = opendir(path.c_str());
@@ -303,51 +431,94 @@ DirLister::Private::nextDir(std::string& path,
         dir = opendir("/");
     }
     if (!dir) {
-        int e = errno;
-        if (mutexLocked) {
-            STRIGI_MUTEX_UNLOCK(&mutex);
-        }
         // if permission is denied, this is not an error
-        return (e == EACCES) ?0 :-1;
+        return (errno == EACCES) ?0 :-1;
     }
     struct dirent* entry = readdir(dir);
     struct stat entrystat;
     while (entry) {
-        entryname.assign(entry->d_name);
-        if (entryname != "." && entryname != "..") {
+        const char* name = entry->d_name;
+        if (!isDotOrDotDot(name)) {
             entrypath.resize(entrypathlength);
-            entrypath.append(entryname);
-            if (strigi_lstat(entrypath.c_str(), &entrystat) == 0) {
-                if (S_ISDIR(entrystat.st_mode)) {
-                    if (config == 0 ||
-                            config->indexDir(
-                                entrypath.c_str(), entryname.c_str())) {
-                        if (!mutexLocked) {
-                            STRIGI_MUTEX_LOCK(&mutex);
-                        }
-                        todoPaths.push_back(entrypath);
-                        STRIGI_MUTEX_UNLOCK(&mutex);
-                        mutexLocked = false;
-                        dirs.push_back(make_pair(entrypath, entrystat));
-                    }
-                } else if (config == 0 || config->indexFile(entrypath.c_str(),
-                        entryname.c_str())) {
+            entrypath.append(name);
+            // when readdir() knows the type, the configuration can reject
+            // the entry before it is stat()ed
+            EntryType type = entryType(entry);
+            bool stated = false;
+            if (type == UnknownEntry) {
+                stated = statEntry(dir, entrypath, name, entrystat) == 0;
+                type = (stated) ?entryType(entrystat) :UnknownEntry;
+            }
+            if (type == DirEntry) {
+                if ((config == 0 ||
+                            config->indexDir(entrypath.c_str(), name))
+                        && (stated || statEntry(dir, entrypath, name,
+                            entrystat) == 0)) {
+                    subdirs.push_back(entrypath);
                     dirs.push_back(make_pair(entrypath, entrystat));
                 }
+            } else if (type != UnknownEntry && (config == 0
+                        || config->indexFile(entrypath.c_str(), name))
+                    && (stated || statEntry(dir, entrypath, name,
+                        entrystat) == 0)) {
+                dirs.push_back(make_pair(entrypath, entrystat));
             }
         }
         entry = readdir(dir);
     }
     closedir(dir);
-    if (mutexLocked) {
+    return 0;
+}
+int
+DirLister::Private::nextDir(int worker, std::string& path,
+        std::vector<std::pair<std::string, struct stat> >& dirs) {
+    // find a directory to work on or wait until another worker has found
+    // one; stop when no directories are queued or being listed
+    STRIGI_MUTEX_LOCK(&mutex);
+    unsigned int seen = generation;
+    STRIGI_MUTEX_UNLOCK(&mutex);
+    while (!take(worker, path)) {
+        STRIGI_MUTEX_LOCK(&mutex);
+        if (pending <= 0) {
+            STRIGI_MUTEX_UNLOCK(&mutex);
+            return -1;
+        }
+        if (seen == generation) {
+            waiting++;
+            STRIGI_COND_WAIT(&workavailable, &mutex);
+            waiting--;
+        }
+        seen = generation;
         STRIGI_MUTEX_UNLOCK(&mutex);
     }
-    return 0;
+
+    dirs.clear();
+    vector<string> subdirs;
+    int r = listDir(path, dirs, subdirs);
+    if (subdirs.size()) {
+        // count the new directories before another worker can take them
+        STRIGI_MUTEX_LOCK(&mutex);
+        pending += (int)subdirs.size();
+        STRIGI_MUTEX_UNLOCK(&mutex);
+        push(worker, subdirs);
+    }
+    STRIGI_MUTEX_LOCK(&mutex);
+    if (--pending <= 0) {
+        // wake up the workers that wait so they can stop
+        STRIGI_COND_BROADCAST(&workavailable);
+    }
+    STRIGI_MUTEX_UNLOCK(&mutex);
+    return r;
 }
 int
 DirLister::nextDir(std::string& path,
         std::vector<std::pair<std::string, struct stat> >& dirs) {
-    return p->nextDir(path, dirs);
+    return p->nextDir(0, path, dirs);
+}
+int
+DirLister::nextDir(int worker, std::string& path,
+        std::vector<std::pair<std::string, struct stat> >& dirs) {
+    return p->nextDir(worker, path, dirs);
 }
 void
 DirLister::skipTillAfter(const std::string& lastToSkip) {
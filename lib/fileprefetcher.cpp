@@ -0,0 +1,249 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#include "fileprefetcher.h"
+#include "mmapinputstream.h"
+#include "uringreader.h"
+#include <strigi/filelister.h>
+#include <strigi/diranalyzer.h>
+#include <strigi/analyzerconfiguration.h>
+#include <strigi/streambase.h>
+
+using namespace Strigi;
+using namespace std;
+
+extern "C" // Linkage for functions passed to pthread_create matters
+{
+void*
+prefetchInThread(void* d) {
+    static_cast<FilePrefetcher*>(d)->fill();
+    STRIGI_THREAD_EXIT(0);
+    return 0; // Return bogus value
+}
+}
+
+namespace {
+// the largest number of files that are read ahead together with io_uring
+const size_t uringdepth = 32;
+/**
+ * Access one byte in every page so that memory mapped data is really read
+ * from disk by this thread.
+ **/
+void
+touchPages(const char* data, int32_t size) {
+    volatile char c;
+    for (int32_t i = 0; i < size; i += 4096) {
+        c = data[i];
+    }
+    (void)c;
+}
+}
+
+FilePrefetcher::Entry::~Entry() {
+    delete stream;
+}
+FilePrefetcher::FilePrefetcher(DirLister& l, AnalyzerConfiguration& c,
+        AnalysisCaller* ac)
+        :lister(l), config(c), caller(ac),
+         maxentries((c.prefetchDepth() > 0) ?c.prefetchDepth() :1),
+         maxmemory(c.prefetchMemory()), memory(0), producers(0), workers(0),
+         stopped(false) {
+    STRIGI_MUTEX_INIT(&mutex);
+    STRIGI_COND_INIT(&notfull);
+    STRIGI_COND_INIT(&notempty);
+}
+FilePrefetcher::~FilePrefetcher() {
+    stop();
+    for (size_t i = 0; i < threads.size(); ++i) {
+        STRIGI_THREAD_JOIN(threads[i]);
+    }
+    deque<Entry*>::iterator i;
+    for (i = queue.begin(); i != queue.end(); ++i) {
+        delete *i;
+    }
+    STRIGI_COND_DESTROY(&notempty);
+    STRIGI_COND_DESTROY(&notfull);
+    STRIGI_MUTEX_DESTROY(&mutex);
+}
+void
+FilePrefetcher::start(int nthreads) {
+    if (nthreads < 1) nthreads = 1;
+    producers = nthreads;
+    threads.resize(nthreads);
+    for (int i = 0; i < nthreads; ++i) {
+        STRIGI_THREAD_CREATE(&threads[i], prefetchInThread, this);
+    }
+}
+void
+FilePrefetcher::stop() {
+    STRIGI_MUTEX_LOCK(&mutex);
+    stopped = true;
+    STRIGI_COND_BROADCAST(&notfull);
+    STRIGI_COND_BROADCAST(&notempty);
+    STRIGI_MUTEX_UNLOCK(&mutex);
+}
+void
+FilePrefetcher::fill() {
+    string parentpath;
+    vector<pair<string, struct stat> > dirfiles;
+    bool more = true;
+    // each I/O thread has its own queue in the DirLister
+    STRIGI_MUTEX_LOCK(&mutex);
+    const int worker = workers++;
+    STRIGI_MUTEX_UNLOCK(&mutex);
+    // with io_uring, the files are read ahead in batches
+    const size_t depth = (maxentries < uringdepth) ?maxentries :uringdepth;
+    UringReader reader((int)depth);
+    vector<Entry*> batch;
+    int r = lister.nextDir(worker, parentpath, dirfiles);
+    while (more && r == 0 && (caller == 0 || caller->continueAnalysis())) {
+        vector<pair<string, struct stat> >::const_iterator end
+            = dirfiles.end();
+        for (vector<pair<string, struct stat> >::const_iterator i
+                = dirfiles.begin(); more && i != end; ++i) {
+            Entry* e = new Entry();
+            e->path.assign(i->first);
+            e->parentpath.assign(parentpath);
+            e->stat = i->second;
+            if (reader.available()) {
+                batch.push_back(e);
+                if (batch.size() == (size_t)reader.depth()) {
+                    more = prefetchBatch(reader, batch);
+                }
+                continue;
+            }
+            if (S_ISREG(e->stat.st_mode)) {
+                prefetch(e);
+            }
+            more = push(e);
+        }
+        if (more && !batch.empty()) {
+            more = prefetchBatch(reader, batch);
+        }
+        if (more) {
+            r = lister.nextDir(worker, parentpath, dirfiles);
+        }
+    }
+    // the last I/O thread to finish wakes up the analysis threads
+    STRIGI_MUTEX_LOCK(&mutex);
+    if (--producers == 0) {
+        STRIGI_COND_BROADCAST(&notempty);
+    }
+    STRIGI_MUTEX_UNLOCK(&mutex);
+}
+int32_t
+FilePrefetcher::readAheadSize(const Entry* e) const {
+    int64_t size = e->stat.st_size;
+    return (size <= config.prefetchWholeFileSize())
+        ?(int32_t)size :config.prefetchSize();
+}
+bool
+FilePrefetcher::prefetchBatch(UringReader& reader, vector<Entry*>& batch) {
+    vector<UringReader::Request> requests;
+    vector<Entry*> files;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        Entry* e = batch[i];
+        if (S_ISREG(e->stat.st_mode)) {
+            UringReader::Request r;
+            r.path = e->path.c_str();
+            r.size = readAheadSize(e);
+            requests.push_back(r);
+            files.push_back(e);
+        }
+    }
+    reader.read(requests);
+    for (size_t i = 0; i < files.size(); ++i) {
+        Entry* e = files[i];
+        const UringReader::Request& r = requests[i];
+        if (r.fd == -1) {
+            // let the analysis thread report the error
+            e->stream = MMapInputStream::open(e->path.c_str(),
+                config.memoryMapping());
+            continue;
+        }
+        // the data is in the page cache now, so mapping it is cheap; a
+        // FileInputStream opens the file again
+        e->stream = MMapInputStream::open(r.fd, r.path, config.memoryMapping());
+        e->cost = (r.nread > 0) ?r.nread :0;
+    }
+    bool more = true;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (more) {
+            more = push(batch[i]);
+        } else {
+            delete batch[i];
+        }
+    }
+    batch.clear();
+    return more;
+}
+void
+FilePrefetcher::prefetch(Entry* e) {
+    e->stream = MMapInputStream::open(e->path.c_str(), config.memoryMapping());
+    if (e->stream == 0) return;
+    int32_t n = readAheadSize(e);
+    if (n <= 0) return;
+    const char* data;
+    int32_t nread = e->stream->read(data, n, n);
+    if (nread > 0) {
+        touchPages(data, nread);
+        e->cost = nread;
+    }
+    if (e->stream->reset(0) != 0) {
+        // let the analysis thread open the file again
+        delete e->stream;
+        e->stream = MMapInputStream::open(e->path.c_str(),
+            config.memoryMapping());
+        e->cost = 0;
+    }
+}
+bool
+FilePrefetcher::push(Entry* e) {
+    STRIGI_MUTEX_LOCK(&mutex);
+    // a single entry is always allowed, even if it is larger than maxmemory
+    while (!stopped && (queue.size() >= maxentries
+            || (!queue.empty() && memory + e->cost > maxmemory))) {
+        STRIGI_COND_WAIT(&notfull, &mutex);
+    }
+    if (stopped) {
+        STRIGI_MUTEX_UNLOCK(&mutex);
+        delete e;
+        return false;
+    }
+    queue.push_back(e);
+    memory += e->cost;
+    STRIGI_COND_SIGNAL(&notempty);
+    STRIGI_MUTEX_UNLOCK(&mutex);
+    return true;
+}
+FilePrefetcher::Entry*
+FilePrefetcher::next() {
+    STRIGI_MUTEX_LOCK(&mutex);
+    while (!stopped && queue.empty() && producers > 0) {
+        STRIGI_COND_WAIT(&notempty, &mutex);
+    }
+    Entry* e = 0;
+    if (!stopped && !queue.empty()) {
+        e = queue.front();
+        queue.pop_front();
+        memory -= e->cost;
+        // more than one waiting I/O thread may fit in the freed memory
+        STRIGI_COND_BROADCAST(&notfull);
+    }
+    STRIGI_MUTEX_UNLOCK(&mutex);
+    return e;
+}
@@ -0,0 +1,116 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef STRIGI_FILEPREFETCHER_H
+#define STRIGI_FILEPREFETCHER_H
+
+#include <strigi/strigiconfig.h>
+#include <strigi/strigi_thread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace Strigi {
+
+template <class T> class StreamBase;
+typedef StreamBase<char> InputStream;
+class DirLister;
+class AnalyzerConfiguration;
+class AnalysisCaller;
+class UringReader;
+
+/**
+ * Read-ahead stage between the DirLister and the analysis threads of the
+ * DirAnalyzer.
+ *
+ * A small number of I/O threads take directories from the DirLister, open
+ * the regular files in them and read the first bytes, or the complete file
+ * if it is small, so that the data is in memory when an analysis thread
+ * picks the file up with next(). Where io_uring is available, the files
+ * of a directory are opened and read in batches by a UringReader. The
+ * number of waiting files and the number of bytes they hold are bounded by
+ * the AnalyzerConfiguration.
+ **/
+class FilePrefetcher {
+public:
+    class Entry {
+    public:
+        std::string path;
+        std::string parentpath;
+        struct stat stat;
+        /** The opened file or 0 if the entry is not a regular file. */
+        InputStream* stream;
+        /** The number of bytes that were read ahead. */
+        int64_t cost;
+
+        Entry() :stream(0), cost(0) {}
+        ~Entry();
+    };
+private:
+    DirLister& lister;
+    AnalyzerConfiguration& config;
+    AnalysisCaller* const caller;
+    const size_t maxentries;
+    const int64_t maxmemory;
+    std::deque<Entry*> queue;
+    int64_t memory;
+    int producers;
+    // the number of I/O threads that have started
+    int workers;
+    bool stopped;
+    std::vector<STRIGI_THREAD_TYPE> threads;
+    STRIGI_MUTEX_DEFINE(mutex);
+    STRIGI_COND_DEFINE(notfull);
+    STRIGI_COND_DEFINE(notempty);
+
+    bool push(Entry* e);
+    int32_t readAheadSize(const Entry* e) const;
+    void prefetch(Entry* e);
+    bool prefetchBatch(UringReader& reader, std::vector<Entry*>& batch);
+public:
+    FilePrefetcher(DirLister& l, AnalyzerConfiguration& c,
+        AnalysisCaller* caller);
+    /**
+     * Stops the I/O threads and deletes the entries that were not taken.
+     **/
+    ~FilePrefetcher();
+    /**
+     * Start @p nthreads I/O threads.
+     **/
+    void start(int nthreads);
+    /**
+     * Take the next file. This blocks until a file is ready.
+     * @return the next entry, which the caller must delete, or 0 if all
+     *         files have been listed or the prefetcher was stopped
+     **/
+    Entry* next();
+    /**
+     * Let the I/O threads stop at the next file and wake up all waiting
+     * threads.
+     **/
+    void stop();
+    /**
+     * The loop of an I/O thread. Only to be called by start().
+     **/
+    void fill();
+};
+
+}
+
+#endif
@@ -0,0 +1,37 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <strigi/indexwriter.h>
+#include <strigi/analysisresult.h>
+#include <strigi/analyzerconfiguration.h>
+#include <strigi/fieldtypes.h>
+
+using namespace Strigi;
+
+void
+IndexWriter::addTriplet(const AnalysisResult* result,
+        const std::string& subject, uint32_t predicate,
+        const std::string& object) {
+    const FieldRegister& r = result->config().fieldRegister();
+    addTriplet(subject, r.symbol(predicate), object);
+}
+void
+IndexWriter::addTriplet(const AnalysisResult* result,
+        const std::string& subject, uint32_t predicate, uint32_t object) {
+    const FieldRegister& r = result->config().fieldRegister();
+    addTriplet(subject, r.symbol(predicate), r.symbol(object));
+}
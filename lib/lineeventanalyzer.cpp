@@ -23,6 +23,7 @@
 #endif
 
 #include "lineeventanalyzer.h"
+#include "utf8validator.h"
 #include <strigi/streamlineanalyzer.h>
 #include <strigi/analysisresult.h>
 #include <strigi/textutils.h>
@@ -32,6 +33,12 @@
 using namespace Strigi;
 using namespace std;
 
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRIGI_LINE_SSE2
+#include <emmintrin.h>
+#endif
+
 #ifdef ICONV_SECOND_ARGUMENT_IS_CONST
      #define ICONV_CONST const
 #else
@@ -41,6 +48,49 @@ using namespace std;
 // end of line is \r, \n or \r\n
 #define CONVBUFSIZE 65536
 
+namespace {
+
+/**
+ * Return a pointer to the first '\n' or '\r' in the range or @p end if
+ * there is none.
+ **/
+const char*
+findLineEnd(const char* p, const char* end) {
+#ifdef STRIGI_LINE_SSE2
+    const __m128i nl = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, nl),
+                _mm_cmpeq_epi8(v, cr)))) {
+            break;
+        }
+        p += 16;
+    }
+#else
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t high = 0x8080808080808080ULL;
+    while (end - p >= 8) {
+        uint64_t w;
+        memcpy(&w, p, 8);
+        // xor turns the wanted bytes into zero bytes, which are found with
+        // the usual borrow trick
+        uint64_t n = w ^ ('\n'*ones);
+        uint64_t r = w ^ ('\r'*ones);
+        if ((((n - ones) & ~n) | ((r - ones) & ~r)) & high) {
+            break;
+        }
+        p += 8;
+    }
+#endif
+    while (p < end && *p != '\n' && *p != '\r') {
+        p++;
+    }
+    return p;
+}
+
+}
+
 LineEventAnalyzer::LineEventAnalyzer(vector<StreamLineAnalyzer*>& l)
         :line(l), converter((iconv_t)-1), numAnalyzers((uint)l.size()),
          convBuffer(new char[CONVBUFSIZE]), ready(true), initialized(false) {
@@ -78,8 +128,10 @@ LineEventAnalyzer::startAnalysis(AnalysisResult* r) {
 }
 void
 LineEventAnalyzer::initEncoding(std::string enc) {
-    if (enc.size() == 0 || enc == "UTF-8") {
-        encoding.assign("UTF-8");
+    // the built-in transcoder is used if it knows the encoding
+    const bool simple = transcoder.init(enc);
+    if (enc.size() == 0 || enc == "UTF-8" || simple) {
+        encoding.assign((enc.size()) ?enc :"UTF-8");
         if (converter != (iconv_t)-1) {
             iconv_close(converter);
             converter = (iconv_t)-1;
@@ -92,14 +144,17 @@ LineEventAnalyzer::initEncoding(std::string enc) {
         if (converter != (iconv_t)-1) {
             iconv_close(converter);
         }
-        converter = iconv_open(encoding.c_str(), "UTF-8");
+        converter = iconv_open("UTF-8", encoding.c_str());
     }
 }
 void
 LineEventAnalyzer::endAnalysis(bool complete) {
     // flush the last line if it did not end with a newline character
-    if(complete && lineBuffer.size() > 0) {
-        emitData(lineBuffer.c_str(), (uint32_t)lineBuffer.size());
+    if(complete && lineBuffer.size() > 0 && !ready) {
+        LineView l;
+        l.data = lineBuffer.c_str();
+        l.length = (uint32_t)lineBuffer.size();
+        emitLines(&l, 1);
         lineBuffer.assign("");
     }
 
@@ -112,6 +167,22 @@ LineEventAnalyzer::endAnalysis(bool complete) {
 void
 LineEventAnalyzer::handleData(const char* data, uint32_t length) {
     if (ready) return;
+    if (transcoder.active()) {
+        // convert in pieces that are sure to fit in the buffer
+        const uint32_t piece = (CONVBUFSIZE-4)/3;
+        while (length > 0 && !ready) {
+            uint32_t n = (length < piece) ?length :piece;
+            int32_t m = transcoder.convert(data, n, convBuffer);
+            if (m < 0) { // invalid input
+                ready = true;
+                return;
+            }
+            handleUtf8Data(convBuffer, (uint32_t)m);
+            data += n;
+            length -= n;
+        }
+        return;
+    }
     if (converter == (iconv_t)-1) {
         handleUtf8Data(data, length);
         return;
@@ -180,8 +251,8 @@ LineEventAnalyzer::handleUtf8Data(const char* data, uint32_t length) {
     assert(!(sawCarriageReturn && missingBytes > 0));
 
     // if the last block ended with '\r', the next '\n' can be skipped
-    if (sawCarriageReturn) {
-        if (length > 0 && data[0] == '\n') {
+    if (sawCarriageReturn && length > 0) {
+        if (data[0] == '\n') {
             data++;
             length--;
         }
@@ -194,7 +265,7 @@ LineEventAnalyzer::handleUtf8Data(const char* data, uint32_t length) {
         if (length > (unsigned char)missingBytes) {
             // we have enough data to finish the character
             byteBuffer.append(data, missingBytes);
-            if (!checkUtf8(byteBuffer)) {
+            if (!validateUtf8(byteBuffer)) {
                 // invalid utf8, nothing more to see here
                 ready = true;
                 return;
@@ -214,7 +285,7 @@ LineEventAnalyzer::handleUtf8Data(const char* data, uint32_t length) {
     }
 
     // validate the utf8
-    const char* p = checkUtf8(data, length, missingBytes);
+    const char* p = validateUtf8(data, length, missingBytes);
     if (p) {
         // the data ends in an incomplete character
         if (missingBytes > 0) {
@@ -231,69 +302,52 @@ LineEventAnalyzer::handleUtf8Data(const char* data, uint32_t length) {
         }
     }
 
-    // find the first \n
-    p = data;
+    // collect the lines that end in this block
     const char* end = data + length;
-    while (p < end) {
-        if (*p == '\n' || *p == '\r') break;
-        p++; 
-    }
+    p = findLineEnd(data, end);
     if (p == end) { // no '\n' was found, we put this in the buffer
         lineBuffer.append(data, length);
         return;
     }
-    const char* lineend = p;
-    if (*p == '\r') {
-        // if \r is followed by \n, we can ignore \n
-        if (p + 1 != end) {
-            if (p[1] == '\n') {
-                p++;
-            }
-        } else {
-            sawCarriageReturn = true;
-        }
-    }
-
-    // handle the first line from this call
+    lines.clear();
     if (lineBuffer.size()) {
-        lineBuffer.append(data, lineend-data);
-        emitData(lineBuffer.c_str(), (uint32_t)lineBuffer.size());
-        lineBuffer.assign("");
+        // complete the line that started in an earlier block
+        lineBuffer.append(data, p-data);
+        addLine(lineBuffer.c_str(), lineBuffer.size());
     } else {
-        emitData(data, (uint32_t)(p-data));
+        addLine(data, p-data);
     }
-    if (ready) return;
-
-    // handle the other lines
-    while (++p != end) {
-        data = p;
-        do {
-            if (*p == '\n' || *p == '\r') break; 
-        } while (++p != end);
-        if (p == end) {
-            lineBuffer.assign(data, end-data);
-            break;
-        }
-        lineend = p;
+    do {
         if (*p == '\r') {
             // if \r is followed by \n, we can ignore \n
-            if (p + 1 != end) {
-                if (p[1] == '\n') {
-                    p++;
-                }
-            } else {
+            if (p + 1 == end) {
                 sawCarriageReturn = true;
+            } else if (p[1] == '\n') {
+                p++;
             }
         }
-        emitData(data, (uint32_t)(lineend-data));
-        if (ready) return;
-    }
+        data = ++p;
+        p = findLineEnd(p, end);
+        if (p == end) {
+            break;
+        }
+        addLine(data, p-data);
+    } while (true);
+    emitLines(&lines[0], (uint32_t)lines.size());
+
+    // lineBuffer may only be changed after the lines have been handled
+    lineBuffer.assign(data, end-data);
+}
+void
+LineEventAnalyzer::addLine(const char* data, size_t length) {
+    LineView l;
+    l.data = data;
+    l.length = (uint32_t)length;
+    lines.push_back(l);
 }
 void
-LineEventAnalyzer::emitData(const char*data, uint32_t length) {
-//    fprintf(stderr, "%.*s\n", length, data);
+LineEventAnalyzer::emitLines(const LineView* l, uint32_t n) {
     bool more = false;
-    vector<StreamLineAnalyzer*>::iterator i;
     if (!initialized) {
         for (uint j = 0; j < numAnalyzers; ++j) {
             StreamLineAnalyzer* s = line[j];
@@ -308,9 +362,10 @@ LineEventAnalyzer::emitData(const char*data, uint32_t length) {
         }
         more = false;
     }
+    vector<StreamLineAnalyzer*>::iterator i;
     for (i = line.begin(); i != line.end(); ++i) {
         if (!(*i)->isReadyWithStream()) {
-            (*i)->handleLine(data, length);
+            (*i)->handleLines(l, n);
         }
         more = more || !(*i)->isReadyWithStream();
     }
@@ -23,12 +23,13 @@
 
 #include <strigi/strigiconfig.h>
 #include <strigi/streameventanalyzer.h>
+#include <strigi/streamlineanalyzer.h>
+#include "simpletranscoder.h"
 #include <vector>
 #include <string>
 #include <iconv.h>
 
 namespace Strigi {
-class StreamLineAnalyzer;
 class LineEventAnalyzer : public StreamEventAnalyzer {
 private:
     std::vector<StreamLineAnalyzer*> line;
@@ -36,8 +37,12 @@ private:
     std::string byteBuffer;
     std::string ibyteBuffer;
     std::string lineBuffer;
+    // the lines found in the current block
+    std::vector<LineView> lines;
     std::string encoding;
     AnalysisResult* result;
+    // used instead of the converter for the common encodings
+    SimpleTranscoder transcoder;
     iconv_t converter;
     const uint numAnalyzers;
     char* const convBuffer;
@@ -54,7 +59,8 @@ private:
     void handleData(const char* data, uint32_t length);
     void handleUtf8Data(const char* data, uint32_t length);
     bool isReadyWithStream();
-    void emitData(const char* data, uint32_t length);
+    void addLine(const char* data, size_t length);
+    void emitLines(const LineView* lines, uint32_t n);
     void initEncoding(std::string encoding);
 public:
     explicit LineEventAnalyzer(std::vector<StreamLineAnalyzer*>&s);
@@ -0,0 +1,253 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "mmapinputstream.h"
+#include <strigi/fileinputstream.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#include <signal.h>
+#include <strigi/strigi_thread.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+#include <climits>
+
+using namespace Strigi;
+
+#ifdef HAVE_SYS_MMAN_H
+namespace {
+
+/**
+ * The mappings in use. The SIGBUS handler only reads this table, so it can
+ * run at any moment. A slot is free when its start is 0.
+ **/
+struct GuardedMapping {
+    const char* volatile start;
+    volatile size_t size;
+    volatile sig_atomic_t truncated;
+};
+const int nguarded = 256;
+GuardedMapping guarded[nguarded];
+StrigiMutex guardmutex;
+bool guardinstalled = false;
+struct sigaction previousbusaction;
+size_t pagesize;
+
+extern "C" void
+handleBus(int sig, siginfo_t* info, void* context) {
+    const char* addr = static_cast<const char*>(info->si_addr);
+    for (int i = 0; i < nguarded; ++i) {
+        const char* start = guarded[i].start;
+        if (start == 0 || addr < start || addr >= start + guarded[i].size) {
+            continue;
+        }
+        // the file is shorter than the mapping: let the page read as zeros
+        void* page = (void*)(start + (addr - start) / pagesize * pagesize);
+        if (mmap(page, pagesize, PROT_READ,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0)
+                != MAP_FAILED) {
+            guarded[i].truncated = 1;
+            return;
+        }
+        break;
+    }
+    // not a fault in one of the mappings
+    if (previousbusaction.sa_flags & SA_SIGINFO) {
+        previousbusaction.sa_sigaction(sig, info, context);
+    } else if (previousbusaction.sa_handler != SIG_DFL
+            && previousbusaction.sa_handler != SIG_IGN) {
+        previousbusaction.sa_handler(sig);
+    } else {
+        // the faulting instruction runs again and the default action ends
+        // the process
+        signal(sig, SIG_DFL);
+    }
+}
+/**
+ * Register a mapping with the SIGBUS handler.
+ * @return the slot of the mapping or -1 if it could not be registered
+ **/
+int
+guardMapping(const char* start, size_t size) {
+    int slot = -1;
+    guardmutex.lock();
+    if (!guardinstalled) {
+        pagesize = (size_t)sysconf(_SC_PAGESIZE);
+        struct sigaction action;
+        action.sa_sigaction = handleBus;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        guardinstalled = sigaction(SIGBUS, &action, &previousbusaction) == 0;
+    }
+    for (int i = 0; guardinstalled && i < nguarded; ++i) {
+        if (guarded[i].start == 0) {
+            guarded[i].size = size;
+            guarded[i].truncated = 0;
+            __sync_synchronize();
+            guarded[i].start = start;
+            slot = i;
+            break;
+        }
+    }
+    guardmutex.unlock();
+    return slot;
+}
+void
+unguardMapping(int slot) {
+    guardmutex.lock();
+    guarded[slot].start = 0;
+    __sync_synchronize();
+    guardmutex.unlock();
+}
+
+}
+#endif
+
+MMapInputStream::MMapInputStream(const char* data, int64_t size, int guard)
+        :m_data(data), m_mappedsize((size_t)size), m_guard(guard) {
+    m_size = size;
+    m_position = 0;
+    m_status = (size == 0) ?Eof :Ok;
+}
+MMapInputStream::~MMapInputStream() {
+#ifdef HAVE_SYS_MMAN_H
+    if (m_guard != -1) {
+        unguardMapping(m_guard);
+    }
+    if (m_mappedsize) {
+        munmap((void*)m_data, m_mappedsize);
+    }
+#endif
+}
+int32_t
+MMapInputStream::read(const char*& start, int32_t /*min*/, int32_t max) {
+#ifdef HAVE_SYS_MMAN_H
+    if (m_guard != -1 && guarded[m_guard].truncated) {
+        // data that was handed out earlier may contain zeros in place of
+        // the end of the file
+        m_error = "file was truncated while it was read";
+        m_status = Error;
+        return -1;
+    }
+#endif
+    int64_t left = m_size - m_position;
+    if (left <= 0) {
+        m_status = Eof;
+        return -1;
+    }
+    // a max smaller than 1 means there is no maximum
+    if (left > INT_MAX) {
+        left = INT_MAX;
+    }
+    int32_t nread = (max < 1 || max > left) ?(int32_t)left :max;
+    start = m_data + m_position;
+    m_position += nread;
+    if (m_position == m_size) {
+        m_status = Eof;
+    }
+    return nread;
+}
+int64_t
+MMapInputStream::skip(int64_t ntoskip) {
+    if (ntoskip <= 0 || m_status != Ok) return 0;
+    int64_t left = m_size - m_position;
+    if (ntoskip > left) {
+        ntoskip = left;
+    }
+    m_position += ntoskip;
+    if (m_position == m_size) {
+        m_status = Eof;
+    }
+    return ntoskip;
+}
+int64_t
+MMapInputStream::reset(int64_t pos) {
+    if (pos < 0) {
+        pos = 0;
+    }
+    if (pos >= m_size) {
+        m_position = m_size;
+        m_status = Eof;
+    } else {
+        m_position = pos;
+        m_status = Ok;
+    }
+    return m_position;
+}
+InputStream*
+MMapInputStream::open(const char* path, bool map) {
+#ifdef HAVE_SYS_MMAN_H
+    int fd = (map) ?::open(path, O_RDONLY) :-1;
+    if (fd != -1) {
+        return open(fd, path, map);
+    }
+#endif
+    return FileInputStream::open(path);
+}
+InputStream*
+MMapInputStream::open(int fd, const char* path, bool map) {
+#ifdef HAVE_SYS_MMAN_H
+    if (!map) {
+        close(fd);
+        return FileInputStream::open(path);
+    }
+    struct stat s;
+    MMapInputStream* stream = 0;
+    // only map regular files whose size fits in the address space
+    if (fstat(fd, &s) == 0 && S_ISREG(s.st_mode)
+            && (uint64_t)s.st_size <= (uint64_t)(size_t)-1) {
+        if (s.st_size == 0) {
+            stream = new MMapInputStream(0, 0, -1);
+        } else {
+#ifdef HAVE_POSIX_FADVISE
+            // widens the kernel readahead window for the page faults
+            posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+            void* m = mmap(0, (size_t)s.st_size, PROT_READ, MAP_PRIVATE,
+                fd, 0);
+            int guard = (m == MAP_FAILED) ?-1
+                :guardMapping((const char*)m, (size_t)s.st_size);
+            if (guard != -1) {
+#ifdef MADV_SEQUENTIAL
+                madvise(m, (size_t)s.st_size, MADV_SEQUENTIAL);
+#endif
+                stream = new MMapInputStream((const char*)m, s.st_size, guard);
+            } else if (m != MAP_FAILED) {
+                // without a guard a truncated file would kill the process
+                munmap(m, (size_t)s.st_size);
+            }
+        }
+    }
+    close(fd);
+    if (stream) {
+        return stream;
+    }
+#else
+    close(fd);
+#endif
+    return FileInputStream::open(path);
+}
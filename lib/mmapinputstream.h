@@ -0,0 +1,78 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef STRIGI_MMAPINPUTSTREAM_H
+#define STRIGI_MMAPINPUTSTREAM_H
+
+#include <strigi/strigiconfig.h>
+#include <strigi/streambase.h>
+
+namespace Strigi {
+
+/**
+ * InputStream that reads a regular file through a read-only memory mapping.
+ *
+ * read() returns pointers into the mapping, so no data is copied and
+ * reset() and skip() only move the position. This makes it cheap for the
+ * StreamAnalyzer to reread the header and to reset the stream after each
+ * end analyzer.
+ *
+ * Use open() to obtain a stream: it falls back to a buffered
+ * FileInputStream for files that are not regular files or that cannot be
+ * mapped, and when mapping is disabled with
+ * AnalyzerConfiguration::setMemoryMapping().
+ *
+ * Reading a mapped page beyond the end of a file that was truncated raises
+ * SIGBUS. The stream installs a handler that puts a page of zeros in place
+ * of such a page, and read() then fails with an error. SIGBUS from
+ * anywhere else is passed on to the handler that was installed before.
+ **/
+class MMapInputStream : public InputStream {
+private:
+    const char* m_data;
+    size_t m_mappedsize;
+    // the slot of the mapping in the SIGBUS handler or -1
+    int m_guard;
+
+    MMapInputStream(const char* data, int64_t size, int guard);
+public:
+    ~MMapInputStream();
+    int32_t read(const char*& start, int32_t min, int32_t max);
+    int64_t skip(int64_t ntoskip);
+    int64_t reset(int64_t pos);
+    /**
+     * @brief Open the file at @p path for reading.
+     *
+     * @param map false to always use a FileInputStream
+     * @return a memory mapped stream if @p map is true and the file is a
+     *         regular file that can be mapped, a FileInputStream otherwise.
+     *         The caller owns the stream.
+     **/
+    static InputStream* open(const char* path, bool map);
+    /**
+     * @brief Create a stream for the file @p path that is already open as
+     * @p fd.
+     *
+     * The stream takes over @p fd, which is closed before this function
+     * returns. If the file is not mapped, it is opened again by path.
+     **/
+    static InputStream* open(int fd, const char* path, bool map);
+};
+
+}
+
+#endif
@@ -27,7 +27,7 @@ using namespace Strigi;
 
 int32_t streamcount = 0;
 
-PdfParser::PdfParser() :streamhandler(0), texthandler(0) {
+PdfParser::PdfParser() :streamhandler(0), texthandler(0), stopped(false) {
 }
 
 StreamStatus
@@ -572,13 +572,17 @@ PdfParser::parse(StreamBase<char>* stream) {
     lastNumber = -1;
     lastName.resize(0);
     lastObject = 0;
+    stopped = false;
 
     r = skipWhitespaceOrComment();
     if (r != Ok) {
         fprintf(stderr, "Error: %s\n", stream->error());
         return r;
     }
-    while ((r = parseObjectStreamObjectDef()) == Ok) {};
+    while (!stopped && (r = parseObjectStreamObjectDef()) == Ok) {};
+    if (stopped) {
+        return Eof;
+    }
 //    fprintf(stderr, "%i %i %i\n", r, streamcount, Eof);
     if (r == Error) {
         fprintf(stderr, "Error in parsing: %s\n", m_error.c_str());
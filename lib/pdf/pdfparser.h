@@ -59,6 +59,7 @@ private:
     // event handlers
     StreamHandler* streamhandler;
     TextHandler* texthandler;
+    bool stopped;
 
     Strigi::StreamStatus read(int32_t min, int32_t max);
     void forwardStream(Strigi::StreamBase<char>* s);
@@ -104,6 +105,10 @@ public:
     const std::string& error() { return m_error; }
     void setStreamHandler(StreamHandler* handler) { streamhandler = handler; }
     void setTextHandler(TextHandler* handler) { texthandler = handler; }
+    /**
+     * Stop parsing after the current object. parse() will return Eof.
+     **/
+    void stop() { stopped = true; }
 };
 
 #endif
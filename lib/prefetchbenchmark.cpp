@@ -0,0 +1,151 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Compares reading the first bytes of all files below a directory one file
+ * at a time with reading them in batches with io_uring.
+ *
+ * Before each run the files are dropped from the page cache with
+ * posix_fadvise(), so both runs start with a cold cache. That only works
+ * for files that are not mapped or dirty.
+ *
+ * usage: prefetchbenchmark DIR [BATCHSIZE]
+ */
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "uringreader.h"
+#include "analyzertimer.h"
+#include <strigi/filelister.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Strigi;
+using namespace std;
+
+namespace {
+
+const int32_t readsize = 65536;
+
+void
+listFiles(const string& dir, vector<string>& files) {
+    DirLister lister;
+    lister.startListing(dir);
+    string path;
+    vector<pair<string, struct stat> > entries;
+    while (lister.nextDir(path, entries) == 0) {
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (S_ISREG(entries[i].second.st_mode)) {
+                files.push_back(entries[i].first);
+            }
+        }
+    }
+}
+
+void
+dropFromCache(const vector<string>& files) {
+    for (size_t i = 0; i < files.size(); ++i) {
+        int fd = open(files[i].c_str(), O_RDONLY);
+        if (fd != -1) {
+#ifdef HAVE_POSIX_FADVISE
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+            close(fd);
+        }
+    }
+}
+
+int64_t
+readOneByOne(const vector<string>& files) {
+    vector<char> buffer(readsize);
+    int64_t total = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        int fd = open(files[i].c_str(), O_RDONLY);
+        if (fd != -1) {
+            ssize_t n = read(fd, &buffer[0], readsize);
+            if (n > 0) total += n;
+            close(fd);
+        }
+    }
+    return total;
+}
+
+int64_t
+readInBatches(UringReader& reader, const vector<string>& files) {
+    int64_t total = 0;
+    vector<UringReader::Request> requests;
+    for (size_t i = 0; i < files.size(); i += reader.depth()) {
+        requests.clear();
+        for (size_t j = i; j < files.size() && j < i + reader.depth(); ++j) {
+            UringReader::Request r;
+            r.path = files[j].c_str();
+            r.size = readsize;
+            requests.push_back(r);
+        }
+        reader.read(requests);
+        for (size_t j = 0; j < requests.size(); ++j) {
+            if (requests[j].nread > 0) total += requests[j].nread;
+            if (requests[j].fd != -1) close(requests[j].fd);
+        }
+    }
+    return total;
+}
+
+void
+report(const char* name, size_t nfiles, int64_t bytes, int64_t usecs) {
+    double s = (usecs > 0) ?usecs/1e6 :1e-6;
+    printf("%-12s %10.3f s %12.0f files/s %10.1f MB/s\n", name, s,
+        nfiles/s, bytes/s/1e6);
+}
+
+}
+
+int
+main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s DIR [BATCHSIZE]\n", argv[0]);
+        return 1;
+    }
+    int depth = (argc > 2) ?atoi(argv[2]) :32;
+    UringReader reader(depth);
+    if (!reader.available()) {
+        fprintf(stderr, "io_uring is not available, the batched run reads "
+            "the files one by one too.\n");
+    }
+    vector<string> files;
+    listFiles(argv[1], files);
+    printf("%u files\n", (unsigned)files.size());
+
+    dropFromCache(files);
+    int64_t start = AnalyzerTimer::now(false);
+    int64_t bytes = readOneByOne(files);
+    report("one by one", files.size(), bytes,
+        AnalyzerTimer::now(false) - start);
+
+    dropFromCache(files);
+    start = AnalyzerTimer::now(false);
+    bytes = readInBatches(reader, files);
+    report("io_uring", files.size(), bytes,
+        AnalyzerTimer::now(false) - start);
+    return 0;
+}
@@ -0,0 +1,75 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#include "signatureindex.h"
+#include <strigi/streamendanalyzer.h>
+#include <cstring>
+
+using namespace Strigi;
+using namespace std;
+
+void
+SignatureIndex::build(const vector<StreamEndAnalyzerFactory*>& factories) {
+    tables.clear();
+    unconditional.assign(factories.size(), 1);
+    for (uint32_t f = 0; f < factories.size(); ++f) {
+        const vector<StreamSignature>& sigs = factories[f]->signatures();
+        if (sigs.size() == 0) {
+            continue;
+        }
+        unconditional[f] = 0;
+        vector<StreamSignature>::const_iterator s;
+        for (s = sigs.begin(); s != sigs.end(); ++s) {
+            // find or create the table for this offset
+            vector<OffsetTable>::iterator t = tables.begin();
+            while (t != tables.end() && t->offset != s->offset) {
+                ++t;
+            }
+            if (t == tables.end()) {
+                tables.push_back(OffsetTable());
+                t = tables.end() - 1;
+                t->offset = s->offset;
+            }
+            Entry e;
+            e.rest.assign(s->magic, 1, string::npos);
+            e.factory = f;
+            t->buckets[(unsigned char)s->magic[0]].push_back(e);
+        }
+    }
+}
+void
+SignatureIndex::match(const char* header, int32_t headersize,
+        vector<char>& candidates) const {
+    candidates = unconditional;
+    vector<OffsetTable>::const_iterator t;
+    for (t = tables.begin(); t != tables.end(); ++t) {
+        if (t->offset >= headersize) {
+            continue;
+        }
+        const vector<Entry>& bucket
+            = t->buckets[(unsigned char)header[t->offset]];
+        const char* start = header + t->offset + 1;
+        int32_t left = headersize - t->offset - 1;
+        vector<Entry>::const_iterator e;
+        for (e = bucket.begin(); e != bucket.end(); ++e) {
+            if ((int32_t)e->rest.size() <= left
+                    && memcmp(start, e->rest.data(), e->rest.size()) == 0) {
+                candidates[e->factory] = 1;
+            }
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef STRIGI_SIGNATUREINDEX_H
+#define STRIGI_SIGNATUREINDEX_H
+
+#include <strigi/strigiconfig.h>
+#include <string>
+#include <vector>
+
+namespace Strigi {
+
+class StreamEndAnalyzerFactory;
+
+/**
+ * Lookup table built from the signatures declared by the end analyzer
+ * factories. For each distinct signature offset, the signatures are bucketed
+ * on their first byte, so matching a header costs one table lookup per offset
+ * plus a memcmp for each signature in the bucket.
+ **/
+class SignatureIndex {
+private:
+    struct Entry {
+        std::string rest;
+        uint32_t factory;
+    };
+    struct OffsetTable {
+        int32_t offset;
+        std::vector<Entry> buckets[256];
+    };
+    std::vector<OffsetTable> tables;
+    std::vector<char> unconditional;
+public:
+    /**
+     * Build the table from the signatures of @p factories.
+     **/
+    void build(const std::vector<StreamEndAnalyzerFactory*>& factories);
+    /**
+     * Determine for which factories StreamEndAnalyzer::checkHeader() should be
+     * called. After the call, @p candidates has one entry per factory in
+     * the order passed to build(). An entry is 1 if the factory declares no
+     * signatures or if one of its signatures matches @p header.
+     **/
+    void match(const char* header, int32_t headersize,
+        std::vector<char>& candidates) const;
+};
+
+}
+
+#endif
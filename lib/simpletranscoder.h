@@ -0,0 +1,73 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef STRIGI_SIMPLETRANSCODER_H
+#define STRIGI_SIMPLETRANSCODER_H
+
+#include <strigi/strigiconfig.h>
+#include <string>
+
+namespace Strigi {
+
+/**
+ * Converts text in ISO-8859-x, Windows-125x, UTF-16LE or UTF-16BE to utf8
+ * with lookup tables instead of iconv. Characters that are split over two
+ * calls to convert() are completed in the second call.
+ **/
+class SimpleTranscoder {
+private:
+    enum Kind { None, SingleByte, Utf16LE, Utf16BE };
+    Kind kind;
+    // code points of the bytes 0x80-0xff, 0 for ISO-8859-1
+    const uint16_t* table;
+    // a byte of an incomplete UTF-16 code unit or -1
+    int half;
+    // a high surrogate that waits for its low surrogate or 0
+    uint32_t high;
+
+    int32_t convertSingleByte(const char* in, uint32_t length,
+        char* out) const;
+    int32_t convertUtf16(const char* in, uint32_t length, char* out);
+public:
+    SimpleTranscoder() :kind(None), table(0), half(-1), high(0) {}
+    /**
+     * Select the encoding to convert from.
+     * @return false if the encoding is not supported
+     **/
+    bool init(const std::string& encoding);
+    /**
+     * Forget incomplete characters from previous calls to convert().
+     **/
+    void reset();
+    /**
+     * @return true if init() selected a supported encoding
+     **/
+    bool active() const { return kind != None; }
+    /**
+     * Convert @p length bytes from @p in to utf8 in @p out. @p out must
+     * have room for 3*@p length+4 bytes.
+     * @return the number of bytes written or -1 if the input is not valid
+     **/
+    int32_t convert(const char* in, uint32_t length, char* out) {
+        return (kind == SingleByte) ?convertSingleByte(in, length, out)
+            :convertUtf16(in, length, out);
+    }
+};
+
+}
+
+#endif
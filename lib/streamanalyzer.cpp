@@ -18,49 +18,27 @@
  * Boston, MA 02110-1301, USA.
  */
 #include <strigi/streamanalyzer.h>
-#include <strigi/fileinputstream.h>
 #include <strigi/streamendanalyzer.h>
 #include <strigi/streamthroughanalyzer.h>
 #include <strigi/streamlineanalyzer.h>
 #include <strigi/streameventanalyzer.h>
 #include <strigi/streamsaxanalyzer.h>
-#include "endanalyzers/bz2endanalyzer.h"
-#include "endanalyzers/lzmaendanalyzer.h"
-#include "eventanalyzers/mimeeventanalyzer.h"
-#include "endanalyzers/bmpendanalyzer.h"
-#include "endanalyzers/textendanalyzer.h"
-#include "endanalyzers/tarendanalyzer.h"
-#include "endanalyzers/arendanalyzer.h"
-#include "endanalyzers/zipexeendanalyzer.h"
-#include "endanalyzers/odfendanalyzer.h"
-#include "endanalyzers/oleendanalyzer.h"
-#include "endanalyzers/rpmendanalyzer.h"
-#include "endanalyzers/cpioendanalyzer.h"
-#include "endanalyzers/pdfendanalyzer.h"
-#include "endanalyzers/sdfendanalyzer.h"
-#include "endanalyzers/pngendanalyzer.h"
-#include "endanalyzers/gzipendanalyzer.h"
-#include "lineanalyzers/m3ustreamanalyzer.h"
-#include "endanalyzers/mailendanalyzer.h"
-#include "endanalyzers/mpegendanalyzer.h"
-#include "endanalyzers/helperendanalyzer.h"
-#include <strigi/dataeventinputstream.h>
-#include "endanalyzers/id3endanalyzer.h"
-#include "throughanalyzers/oggthroughanalyzer.h"
-#include "endanalyzers/flacendanalyzer.h"
 #include <strigi/analysisresult.h>
 #include <strigi/indexwriter.h>
 #include <strigi/analyzerconfiguration.h>
 #include <strigi/textutils.h>
-#include "analyzerloader.h"
 #include "eventthroughanalyzer.h"
-#include "saxanalyzers/htmlsaxanalyzer.h"
-#include <strigi/indexpluginloader.h>
+#include "analyzerfactoryset.h"
+#include "endanalyzerranking.h"
+#include "mmapinputstream.h"
+#include "analyzertimer.h"
+#include "utf8validator.h"
 #include <sys/stat.h>
 #ifdef WIN32
  //#include "ifilterendanalyzer.h"
 #endif
 #include <iostream>
+#include <cctype>
 #include <config.h>
 
 using namespace std;
@@ -71,32 +49,34 @@ namespace Strigi {
 class StreamAnalyzerPrivate {
 public:
     AnalyzerConfiguration& conf;
-    vector<StreamThroughAnalyzerFactory*> throughfactories;
-    vector<StreamEndAnalyzerFactory*> endfactories;
-    vector<StreamSaxAnalyzerFactory*> saxfactories;
-    vector<StreamLineAnalyzerFactory*> linefactories;
-    vector<StreamEventAnalyzerFactory*> eventfactories;
+    // the factories are shared with other StreamAnalyzers
+    AnalyzerFactorySet* const factories;
+    const vector<StreamThroughAnalyzerFactory*>& throughfactories;
+    const vector<StreamEndAnalyzerFactory*>& endfactories;
+    const SignatureIndex& signatures;
+    const RegisteredField* const sizefield;
     vector<vector<StreamEndAnalyzer*> > end;
     vector<vector<StreamThroughAnalyzer*> > through;
+    // per depth: counters for the analyzers in 'end' and 'through'
+    vector<vector<AnalyzerStatistics> > endstats;
+    vector<vector<AnalyzerStatistics> > throughstats;
+    // counters of event analyzers at depths that have been trimmed
+    vector<AnalyzerStatistics> retiredstats;
+    // per depth: which end analyzers should get to see the header
+    vector<vector<char> > endcandidates;
     IndexWriter* writer;
 
-    AnalyzerLoader* moduleLoader;
-    const RegisteredField* sizefield;
-    const RegisteredField* errorfield;
-    void initializeThroughFactories();
-    void initializeEndFactories();
-    void initializeSaxFactories();
-    void initializeLineFactories();
-    void initializeEventFactories();
-    void addFactory(StreamThroughAnalyzerFactory* f);
-    void addFactory(StreamEndAnalyzerFactory* f);
-    void addFactory(StreamSaxAnalyzerFactory* f);
-    void addFactory(StreamLineAnalyzerFactory* f);
-    void addFactory(StreamEventAnalyzerFactory* f);
     void addThroughAnalyzers();
     void addEndAnalyzers();
-    void removeIndexable(unsigned depth);
+    void trimAnalyzers(unsigned depth);
+    void addEventStatistics(unsigned depth,
+        vector<AnalyzerStatistics>& stats) const;
+    void removeIndexable(unsigned depth, StreamBase<char>* input);
+    string rankingBucket(const AnalysisResult& idx,
+        const vector<size_t>& candidates) const;
+    bool needsDraining(unsigned depth, StreamBase<char>* input);
     signed char analyze(AnalysisResult& idx, StreamBase<char>* input);
+    vector<AnalyzerStatistics> statistics() const;
 
     StreamAnalyzerPrivate(AnalyzerConfiguration& c);
     ~StreamAnalyzerPrivate();
@@ -104,50 +84,13 @@ public:
 
 } // namespace Strigi
 StreamAnalyzerPrivate::StreamAnalyzerPrivate(AnalyzerConfiguration& c)
-        :conf(c), writer(0) {
-    moduleLoader = new AnalyzerLoader();
-    sizefield = c.fieldRegister().sizeField;
-    errorfield = c.fieldRegister().parseErrorField;
-
-    // load the plugins from the environment setting
-    const char* strigipluginpath(getenv("STRIGI_PLUGIN_PATH"));
-    if (strigipluginpath) {
-        vector<string> strigipluginpaths = getdirs(strigipluginpath);
-        for (uint i=0; i<strigipluginpaths.size(); ++i) {
-            moduleLoader->loadPlugins(strigipluginpaths[i].c_str());
-        }
-    } else {
-        moduleLoader->loadPlugins( LIBINSTALLDIR "/strigi");
-    }
-
-    initializeSaxFactories();
-    initializeLineFactories();
-    initializeEventFactories();
-    initializeThroughFactories();
-    initializeEndFactories();
+        :conf(c), factories(AnalyzerFactorySet::acquire(c)),
+         throughfactories(factories->throughfactories),
+         endfactories(factories->endfactories),
+         signatures(factories->signatures),
+         sizefield(factories->sizefield), writer(0) {
 }
 StreamAnalyzerPrivate::~StreamAnalyzerPrivate() {
-    // delete all factories
-    vector<StreamThroughAnalyzerFactory*>::iterator ta;
-    for (ta = throughfactories.begin(); ta != throughfactories.end(); ++ta) {
-        delete *ta;
-    }
-    vector<StreamEndAnalyzerFactory*>::iterator ea;
-    for (ea = endfactories.begin(); ea != endfactories.end(); ++ea) {
-        delete *ea;
-    }
-    vector<StreamSaxAnalyzerFactory*>::iterator sa;
-    for (sa = saxfactories.begin(); sa != saxfactories.end(); ++sa) {
-        delete *sa;
-    }
-    vector<StreamLineAnalyzerFactory*>::iterator la;
-    for (la = linefactories.begin(); la != linefactories.end(); ++la) {
-        delete *la;
-    }
-    vector<StreamEventAnalyzerFactory*>::iterator da;
-    for (da = eventfactories.begin(); da != eventfactories.end(); ++da) {
-        delete *da;
-    }
     // delete the through analyzers and end analyzers
     vector<vector<StreamThroughAnalyzer*> >::iterator tIter;
     for (tIter = through.begin(); tIter != through.end(); ++tIter) {
@@ -163,7 +106,7 @@ StreamAnalyzerPrivate::~StreamAnalyzerPrivate() {
             delete *e;
         }
     }
-    delete moduleLoader;
+    AnalyzerFactorySet::release(factories);
     if (writer) {
         writer->releaseWriterData(conf.fieldRegister());
     }
@@ -190,7 +133,7 @@ StreamAnalyzer::indexFile(const char *filepath) {
 }
 signed char
 StreamAnalyzer::indexFile(const string& filepath) {
-    if (!checkUtf8(filepath.c_str())) {
+    if (!validateUtf8(filepath)) {
         return 1;
     }
     if (p->writer == 0) {
@@ -201,7 +144,8 @@ StreamAnalyzer::indexFile(const string& filepath) {
     // ensure a decent buffer size
     string name;
     AnalysisResult analysisresult(filepath, s.st_mtime, *p->writer, *this);
-    InputStream* file = FileInputStream::open(filepath.c_str());
+    InputStream* file = MMapInputStream::open(filepath.c_str(),
+        p->conf.memoryMapping());
     signed char r;
     if (file->status() == Ok) {
         r = analysisresult.index(file);
@@ -212,151 +156,79 @@ StreamAnalyzer::indexFile(const string& filepath) {
     return r;
 }
 void
-StreamAnalyzerPrivate::addFactory(StreamThroughAnalyzerFactory* f) {
-    f->registerFields(conf.fieldRegister());
-    if (conf.useFactory(f)) {
-        throughfactories.push_back(f);
-    } else {
-        delete f;
-    }
-}
-void
-StreamAnalyzerPrivate::initializeSaxFactories() {
-    list<StreamSaxAnalyzerFactory*> plugins
-        = moduleLoader->streamSaxAnalyzerFactories();
-    list<StreamSaxAnalyzerFactory*>::iterator i;
-    for (i = plugins.begin(); i != plugins.end(); ++i) {
-        addFactory(*i);
-    }
-    addFactory(new HtmlSaxAnalyzerFactory());
-}
-void
-StreamAnalyzerPrivate::initializeLineFactories() {
-    list<StreamLineAnalyzerFactory*> plugins
-        = moduleLoader->streamLineAnalyzerFactories();
-    list<StreamLineAnalyzerFactory*>::iterator i;
-    for (i = plugins.begin(); i != plugins.end(); ++i) {
-        addFactory(*i);
-    }
-//    addFactory(new OdfMimeTypeLineAnalyzerFactory());
-    addFactory(new M3uLineAnalyzerFactory());
-}
-void
-StreamAnalyzerPrivate::initializeEventFactories() {
-    list<StreamEventAnalyzerFactory*> plugins
-        = moduleLoader->streamEventAnalyzerFactories();
-    list<StreamEventAnalyzerFactory*>::iterator i;
-    addFactory(new MimeEventAnalyzerFactory());
-    for (i = plugins.begin(); i != plugins.end(); ++i) {
-        addFactory(*i);
-    }
-}
-void
-StreamAnalyzerPrivate::initializeThroughFactories() {
-    list<StreamThroughAnalyzerFactory*> plugins
-        = moduleLoader->streamThroughAnalyzerFactories();
-    list<StreamThroughAnalyzerFactory*>::iterator i;
-    for (i = plugins.begin(); i != plugins.end(); ++i) {
-        addFactory(*i);
-    }
-    addFactory(new OggThroughAnalyzerFactory());
-    addFactory(new EventThroughAnalyzerFactory(saxfactories, linefactories,
-        eventfactories));
-}
-void
-StreamAnalyzerPrivate::addFactory(StreamEventAnalyzerFactory* f) {
-    f->registerFields(conf.fieldRegister());
-    if (conf.useFactory(f)) {
-        eventfactories.push_back(f);
-    } else {
-        delete f;
-    }
-}
-void
-StreamAnalyzerPrivate::addFactory(StreamLineAnalyzerFactory* f) {
-    f->registerFields(conf.fieldRegister());
-    if (conf.useFactory(f)) {
-        linefactories.push_back(f);
-    } else {
-        delete f;
-    }
-}
-void
-StreamAnalyzerPrivate::addFactory(StreamSaxAnalyzerFactory* f) {
-    f->registerFields(conf.fieldRegister());
-    if (conf.useFactory(f)) {
-        saxfactories.push_back(f);
-    } else {
-        delete f;
-    }
-}
-void
-StreamAnalyzerPrivate::addFactory(StreamEndAnalyzerFactory* f) {
-    f->registerFields(conf.fieldRegister());
-    if (conf.useFactory(f)) {
-        endfactories.push_back(f);
-    } else {
-        delete f;
-    }
-}
-/**
- * Instantiate factories for all analyzers.
- **/
-void
-StreamAnalyzerPrivate::initializeEndFactories() {
-    list<StreamEndAnalyzerFactory*> plugins
-        = moduleLoader->streamEndAnalyzerFactories();
-    list<StreamEndAnalyzerFactory*>::iterator i;
-    for (i = plugins.begin(); i != plugins.end(); ++i) {
-        addFactory(*i);
-    }
-    addFactory(new Bz2EndAnalyzerFactory());
-    addFactory(new GZipEndAnalyzerFactory());
-    addFactory(new OleEndAnalyzerFactory());
-    addFactory(new TarEndAnalyzerFactory());
-    addFactory(new ArEndAnalyzerFactory());
-    addFactory(new MailEndAnalyzerFactory());
-//    addFactory(new MpegEndAnalyzerFactory()); //Xine fallback works so much better now
-    addFactory(new OdfEndAnalyzerFactory());
-    addFactory(new ZipEndAnalyzerFactory());
-    addFactory(new ZipExeEndAnalyzerFactory());
-    addFactory(new RpmEndAnalyzerFactory());
-    addFactory(new CpioEndAnalyzerFactory());
-    addFactory(new PngEndAnalyzerFactory());
-    addFactory(new BmpEndAnalyzerFactory());
-    addFactory(new FlacEndAnalyzerFactory());
-    addFactory(new ID3EndAnalyzerFactory());
-    addFactory(new PdfEndAnalyzerFactory());
-    addFactory(new SdfEndAnalyzerFactory());
-    addFactory(new LzmaEndAnalyzerFactory());
-#ifndef _MSC_VER
-    addFactory(new HelperEndAnalyzerFactory());
-#endif
-    addFactory(new TextEndAnalyzerFactory());
-}
-void
 StreamAnalyzerPrivate::addThroughAnalyzers() {
     through.resize(through.size()+1);
     vector<vector<StreamThroughAnalyzer*> >::reverse_iterator tIter;
     tIter = through.rbegin();
-    vector<StreamThroughAnalyzerFactory*>::iterator ta;
+    vector<StreamThroughAnalyzerFactory*>::const_iterator ta;
     for (ta = throughfactories.begin(); ta != throughfactories.end(); ++ta) {
         tIter->push_back((*ta)->newInstance());
     }
+    // the counters of a depth are kept when its analyzers are trimmed
+    if (throughstats.size() < through.size()) {
+        throughstats.resize(through.size());
+        vector<AnalyzerStatistics>& stats = throughstats.back();
+        for (uint i = 0; i < tIter->size(); ++i) {
+            stats.push_back(AnalyzerStatistics());
+            stats.back().name = (*tIter)[i]->name();
+            stats.back().type = AnalyzerStatistics::Through;
+            stats.back().depth = (int)through.size() - 1;
+        }
+    }
 }
+/**
+ * Add a level of end analyzers. The analyzers themselves are only created
+ * when they are first needed in analyze().
+ **/
 void
 StreamAnalyzerPrivate::addEndAnalyzers() {
     end.resize(end.size()+1);
-    vector<vector<StreamEndAnalyzer*> >::reverse_iterator eIter;
-    eIter = end.rbegin();
-    vector<StreamEndAnalyzerFactory*>::iterator ea;
-    for (ea = endfactories.begin(); ea != endfactories.end(); ++ea) {
-        eIter->push_back((*ea)->newInstance());
+    end.back().resize(endfactories.size(), 0);
+    endcandidates.resize(end.size());
+    if (endstats.size() < end.size()) {
+        endstats.resize(end.size());
+        vector<AnalyzerStatistics>& stats = endstats.back();
+        vector<StreamEndAnalyzerFactory*>::const_iterator ea;
+        for (ea = endfactories.begin(); ea != endfactories.end(); ++ea) {
+            stats.push_back(AnalyzerStatistics());
+            stats.back().name = (*ea)->name();
+            stats.back().type = AnalyzerStatistics::End;
+            stats.back().depth = (int)end.size() - 1;
+        }
+    }
+}
+/**
+ * Delete the analyzers for depth @p depth and deeper. This keeps the memory
+ * use bounded after analyzing deeply nested archives.
+ **/
+void
+StreamAnalyzerPrivate::trimAnalyzers(unsigned depth) {
+    for (uint d = depth; d < through.size(); ++d) {
+        addEventStatistics(d, retiredstats);
+        vector<StreamThroughAnalyzer*>::iterator t;
+        for (t = through[d].begin(); t != through[d].end(); ++t) {
+            delete *t;
+        }
+        vector<StreamEndAnalyzer*>::iterator e;
+        for (e = end[d].begin(); e != end[d].end(); ++e) {
+            delete *e;
+        }
+    }
+    if (depth < through.size()) {
+        through.resize(depth);
+        end.resize(depth);
+        endcandidates.resize(depth);
     }
 }
 signed char
 StreamAnalyzer::analyze(AnalysisResult& idx, StreamBase<char>* input) {
-    return p->analyze(idx, input);
+    signed char r = p->analyze(idx, input);
+    if (idx.depth() == 0) {
+        // the analyzers for the deeper levels are idle now
+        int keep = p->conf.analyzerCacheDepth();
+        p->trimAnalyzers((keep < 1) ?1 :keep);
+    }
+    return r;
 }
 signed char
 StreamAnalyzerPrivate::analyze(AnalysisResult& idx, StreamBase<char>* input) {
@@ -386,8 +258,11 @@ StreamAnalyzerPrivate::analyze(AnalysisResult& idx, StreamBase<char>* input) {
 
     // insert the through analyzers
     vector<StreamThroughAnalyzer*>::iterator ts;
+    vector<AnalyzerStatistics>::iterator tstats
+        = throughstats[idx.depth()].begin();
     for (ts = tIter->begin(); (input == 0 || input->status() == Ok)
-            && ts != tIter->end(); ++ts) {
+            && ts != tIter->end(); ++ts, ++tstats) {
+        tstats->invocations++;
         (*ts)->setIndexable(&idx);
         input = (*ts)->connectInputStream(input);
         if (input && input->position() != 0) {
@@ -409,22 +284,64 @@ StreamAnalyzerPrivate::analyze(AnalysisResult& idx, StreamBase<char>* input) {
         headersize = -1;
         finished = true;
     }
-    size_t es = 0;
-    size_t itersize = eIter->size();
-    while (!finished && es != itersize) {
+    // only analyzers without signatures or with a matching signature are
+    // asked to check the header
+    vector<size_t> order;
+    string bucket;
+    const bool adaptive = conf.adaptiveEndAnalyzerOrder();
+    if (!finished) {
+        vector<char>& candidates = endcandidates[idx.depth()];
+        signatures.match(header, headersize, candidates);
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            if (candidates[i]) {
+                order.push_back(i);
+            }
+        }
+        if (adaptive && order.size() > 1) {
+            bucket = rankingBucket(idx, order);
+            endAnalyzerRanking(conf).sort(bucket, endfactories, order);
+        }
+    }
+    size_t next = 0;
+    while (!finished && next != order.size()) {
+        size_t es = order[next++];
         StreamEndAnalyzer* sea = (*eIter)[es];
+        endstats[idx.depth()][es].invocations++;
+        if (sea == 0) {
+            sea = endfactories[es]->newInstance();
+            (*eIter)[es] = sea;
+        }
         if (sea->checkHeader(header, headersize)) {
             idx.setEndAnalyzer(sea);
+            AnalyzerTimer timer;
             char ar = sea->analyze(idx, input);
-            if (ar) {
+            // endstats may have been resized by the analysis of substreams
+            AnalyzerStatistics& stats = endstats[idx.depth()][es];
+            timer.addTo(stats);
+            stats.headerHits++;
+            if (input && input->position() > 0) {
+                stats.bytes += input->position();
+            }
+            if (idx.isTruncated()) {
+                // the time budget ran out, do not try other analyzers
+                stats.budgetHits++;
+            } else if (adaptive && order.size() > 1) {
+                endAnalyzerRanking(conf).record(bucket,
+                    endfactories[es]->name(), ar == 0);
+            }
+            if (ar && !idx.isTruncated()) {
+                stats.failures++;
 // FIXME: find either a NIE-compliant way to report errors or use some API for this
 //                idx.addValue(errorfield, sea->name() + string(": ")
 //                    + sea->error());
                 if (!idx.config().indexMore()) {
-                    removeIndexable(idx.depth());
+                    removeIndexable(idx.depth(), input);
                     return -1;
                 }
                 int64_t pos = input->reset(0);
+                if (pos == 0) {
+                    stats.resets++;
+                }
                 if (pos != 0) { // could not reset
                     cerr << "could not reset stream of " << idx.path().c_str()
                         << " from pos " << input->position()
@@ -449,64 +366,139 @@ StreamAnalyzerPrivate::analyze(AnalysisResult& idx, StreamBase<char>* input) {
         if (!finished) {
             finished = !conf.indexMore();
         }
-        es++;
     }
     idx.setEndAnalyzer(0);
-    if (input) {
-        // make sure the entire stream is read if the size is not known
-        bool ready;
-        tIter = through.begin() + idx.depth();
-        uint32_t skipsize = 4096;
+    if (input && needsDraining(idx.depth(), input)) {
+        // Draining is unavoidable: read the rest in large chunks that are
+        // aligned to the chunk size so the underlying reads are aligned too.
+        const int64_t chunk = 1048576;
         do {
             // ask the analyzerconfiguration if we should continue
             int64_t max = idx.config().maximalStreamReadLength(idx);
-            if (!idx.config().indexMore()
+            if (!idx.config().indexMore() || !idx.withinTimeBudget()
                     || (max != -1 && input->position() >= max)) {
                 // we are done
-                return 0;
-            }
-            ready = input->size() != -1;
-            vector<StreamThroughAnalyzer*>::iterator ts;
-            for (ts = tIter->begin(); ready && ts != tIter->end(); ++ts) {
-                ready = (*ts)->isReadyWithStream();
+                break;
             }
-            if (!ready) {
-                input->skip(skipsize);
-                if (skipsize < 131072) {
-                    skipsize *= 4;
-                }
+            int64_t skipsize = chunk - input->position() % chunk;
+            if (max != -1 && input->position() + skipsize > max) {
+                skipsize = max - input->position();
             }
-        } while (!ready && input->status() == Ok);
-        if (input->status() == Error) {
-            fprintf(stderr, "Error: %s\n", input->error());
-            removeIndexable(idx.depth());
-            return -2;
-        }
+            input->skip(skipsize);
+        } while (input->status() == Ok && needsDraining(idx.depth(), input));
+    }
+    if (input && input->status() == Error) {
+        fprintf(stderr, "Error: %s\n", input->error());
+        removeIndexable(idx.depth(), input);
+        return -2;
     }
 
-    // store the size of the stream
+    // store the size of the stream; for files this is the size from stat()
     if (input && input->status() != Error && input->size() >= 0) {
         // TODO remove cast
         idx.addValue(sizefield, (uint32_t)input->size());
     }
 
-    // remove references to the analysisresult before it goes out of scope
-    removeIndexable(idx.depth());
+    // remove references to the analysisresult before it goes out of scope;
+    // every way out of this function has to pass here, also when the
+    // draining stops early, or the through analyzers keep pointing to it
+    removeIndexable(idx.depth(), input);
     return 0;
 }
+/**
+ * Determine the kind of stream for the adaptive end analyzer order: the
+ * analyzers whose signatures match the header and the file extension.
+ **/
+string
+StreamAnalyzerPrivate::rankingBucket(const AnalysisResult& idx,
+        const vector<size_t>& candidates) const {
+    string bucket;
+    vector<size_t>::const_iterator i;
+    for (i = candidates.begin(); i != candidates.end(); ++i) {
+        if (endfactories[*i]->signatures().size()) {
+            bucket.append(endfactories[*i]->name());
+            bucket.append(",");
+        }
+    }
+    bucket.append(".");
+    string ext(idx.extension());
+    for (string::iterator c = ext.begin(); c != ext.end(); ++c) {
+        *c = (char)tolower(*c);
+    }
+    bucket.append(ext);
+    return bucket;
+}
+/**
+ * Determine if the rest of the stream must be read after the end analyzers
+ * are done. This is only needed when the size of the stream is still unknown
+ * or when a through analyzer wants to see the remaining bytes.
+ **/
+bool
+StreamAnalyzerPrivate::needsDraining(uint depth, StreamBase<char>* input) {
+    if (input->status() != Ok) return false;
+    if (input->size() == -1) return true;
+    vector<StreamThroughAnalyzer*>::const_iterator ts;
+    for (ts = through[depth].begin(); ts != through[depth].end(); ++ts) {
+        if (!(*ts)->isReadyWithStream()) return true;
+    }
+    return false;
+}
 /**
  * Remove references to the analysisresult before it goes out of scope.
+ * This is also where the number of bytes that passed through the through
+ * analyzers is counted.
  **/
 void
-StreamAnalyzerPrivate::removeIndexable(uint depth) {
+StreamAnalyzerPrivate::removeIndexable(uint depth, StreamBase<char>* input) {
     vector<vector<StreamThroughAnalyzer*> >::iterator tIter;
     vector<StreamThroughAnalyzer*>::iterator ts;
     tIter = through.begin() + depth;
-    for (ts = tIter->begin(); ts != tIter->end(); ++ts) {
+    int64_t bytes = (input && input->position() > 0) ?input->position() :0;
+    vector<AnalyzerStatistics>::iterator tstats = throughstats[depth].begin();
+    for (ts = tIter->begin(); ts != tIter->end(); ++ts, ++tstats) {
         // remove references to the analysisresult before it goes out of scope
         (*ts)->setIndexable(0);
+        tstats->bytes += bytes;
+    }
+}
+vector<AnalyzerStatistics>
+StreamAnalyzerPrivate::statistics() const {
+    vector<AnalyzerStatistics> stats;
+    for (uint depth = 0; depth < throughstats.size(); ++depth) {
+        AnalyzerStatistics::merge(stats, throughstats[depth]);
+        AnalyzerStatistics::merge(stats, endstats[depth]);
+    }
+    AnalyzerStatistics::merge(stats, retiredstats);
+    for (uint depth = 0; depth < through.size(); ++depth) {
+        addEventStatistics(depth, stats);
+    }
+    return stats;
+}
+/**
+ * Add the counters of the event analyzers at depth @p depth to @p stats.
+ * The event analyzers are run by the EventThroughAnalyzer.
+ **/
+void
+StreamAnalyzerPrivate::addEventStatistics(uint depth,
+        vector<AnalyzerStatistics>& stats) const {
+    vector<StreamThroughAnalyzer*>::const_iterator ts;
+    for (ts = through[depth].begin(); ts != through[depth].end(); ++ts) {
+        const EventThroughAnalyzer* eta
+            = dynamic_cast<const EventThroughAnalyzer*>(*ts);
+        if (eta) {
+            vector<AnalyzerStatistics> e(eta->statistics());
+            vector<AnalyzerStatistics>::iterator i;
+            for (i = e.begin(); i != e.end(); ++i) {
+                i->depth = (int)depth;
+            }
+            AnalyzerStatistics::merge(stats, e);
+        }
     }
 }
+std::vector<AnalyzerStatistics>
+StreamAnalyzer::statistics() const {
+    return p->statistics();
+}
 AnalyzerConfiguration&
 StreamAnalyzer::configuration() const {
     return p->conf;
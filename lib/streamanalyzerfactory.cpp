@@ -24,6 +24,10 @@ using namespace std;
 class StreamAnalyzerFactory::Private {
 public:
     vector<const RegisteredField*> fields;
+    vector<StreamSignature> signatures;
+    int priority;
+
+    Private() :priority(0) {}
 };
 
 StreamAnalyzerFactory::StreamAnalyzerFactory() : p(new Private()) {}
@@ -39,3 +43,24 @@ void
 StreamAnalyzerFactory::addField(const RegisteredField* f) {
     p->fields.push_back(f);
 }
+void
+StreamAnalyzerFactory::addSignature(const char* magic, int32_t length,
+        int32_t offset) {
+    if (length <= 0 || offset < 0) return;
+    StreamSignature s;
+    s.offset = offset;
+    s.magic.assign(magic, length);
+    p->signatures.push_back(s);
+}
+const std::vector<StreamSignature>&
+StreamAnalyzerFactory::signatures() const {
+    return p->signatures;
+}
+void
+StreamAnalyzerFactory::setPriority(int priority) {
+    p->priority = priority;
+}
+int
+StreamAnalyzerFactory::priority() const {
+    return p->priority;
+}
@@ -68,11 +68,18 @@ OggThroughAnalyzerFactory::registerFields(FieldRegister& r) {
 // ogg spec fields left unimplemented: ORGANIZATION, LOCATION, CONTACT
 
     fields["type"] = r.typeField;
+
+    typeSymbol = r.registerSymbol(typePropertyName);
+    fullnameSymbol = r.registerSymbol(fullnamePropertyName);
+    titleSymbol = r.registerSymbol(titlePropertyName);
+    albumTrackCountSymbol = r.registerSymbol(albumTrackCountName);
+    albumClassSymbol = r.registerSymbol(albumClassName);
+    contactClassSymbol = r.registerSymbol(contactClassName);
 }
 
 inline
 void
-addStatement(AnalysisResult* indexable, string& subject, const string& predicate, const string& object) {
+addStatement(AnalysisResult* indexable, string& subject, uint32_t predicate, const string& object) {
   if (subject.empty())
     subject = indexable->newAnonymousUri();
   indexable->addTriplet(subject, predicate, object);
@@ -168,7 +175,7 @@ OggThroughAnalyzer::connectInputStream(InputStream* in) {
                         // the track number
                         indexable->addValue(iter->second, value.substr(0, pos));
                         // the track count
-                        addStatement(indexable, albumUri, albumTrackCountName, value.substr(pos+1));
+                        addStatement(indexable, albumUri, factory->albumTrackCountSymbol, value.substr(pos+1));
                     }
                     else {
                         indexable->addValue(iter->second, value);
@@ -176,13 +183,13 @@ OggThroughAnalyzer::connectInputStream(InputStream* in) {
                 } else if(name=="artist") {
                     artist = value;
                 } else if(name=="album") {
-                    addStatement(indexable, albumUri, titlePropertyName, value);
+                    addStatement(indexable, albumUri, factory->titleSymbol, value);
 		} else if(name=="composer") {
 		    string composerUri = indexable->newAnonymousUri();
 
 		    indexable->addValue(factory->composerField, composerUri);
-		    indexable->addTriplet(composerUri, typePropertyName, contactClassName);
-		    indexable->addTriplet(composerUri, fullnamePropertyName, value);
+		    indexable->addTriplet(composerUri, factory->typeSymbol, factory->contactClassSymbol);
+		    indexable->addTriplet(composerUri, factory->fullnameSymbol, value);
 		} else if(name=="performer") {
                     performer = value;
 		}
@@ -213,19 +220,19 @@ OggThroughAnalyzer::connectInputStream(InputStream* in) {
         const string artistUri( indexable->newAnonymousUri() );
 
         indexable->addValue(artistField, artistUri);
-        indexable->addTriplet(artistUri, typePropertyName, contactClassName);
-        indexable->addTriplet(artistUri, fullnamePropertyName, artist);
+        indexable->addTriplet(artistUri, factory->typeSymbol, factory->contactClassSymbol);
+        indexable->addTriplet(artistUri, factory->fullnameSymbol, artist);
     }
     if (performerField) {
         const string performerUri( indexable->newAnonymousUri() );
 
         indexable->addValue(performerField, performerUri);
-        indexable->addTriplet(performerUri, typePropertyName, contactClassName);
-        indexable->addTriplet(performerUri, fullnamePropertyName, performer);
+        indexable->addTriplet(performerUri, factory->typeSymbol, factory->contactClassSymbol);
+        indexable->addTriplet(performerUri, factory->fullnameSymbol, performer);
     }
     if(!albumUri.empty()) {
       indexable->addValue(factory->albumField, albumUri);
-      indexable->addTriplet(albumUri, typePropertyName, albumClassName);
+      indexable->addTriplet(albumUri, factory->typeSymbol, factory->albumClassSymbol);
     }
 
     // set the "codec" value
@@ -52,6 +52,13 @@ private:
     const Strigi::RegisteredField* albumField;
     const Strigi::RegisteredField* composerField;
     const Strigi::RegisteredField* performerField;
+
+    uint32_t typeSymbol;
+    uint32_t fullnameSymbol;
+    uint32_t titleSymbol;
+    uint32_t albumTrackCountSymbol;
+    uint32_t albumClassSymbol;
+    uint32_t contactClassSymbol;
     const char* name() const {
         return "OggThroughAnalyzer";
     }
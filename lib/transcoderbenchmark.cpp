@@ -0,0 +1,132 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Compares the throughput of SimpleTranscoder with that of iconv for a few
+ * encodings. The input is converted in blocks of the size that
+ * LineEventAnalyzer uses.
+ */
+#include "simpletranscoder.h"
+#include "analyzertimer.h"
+#include <iconv.h>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#ifdef ICONV_SECOND_ARGUMENT_IS_CONST
+     #define ICONV_CONST const
+#else
+     #define ICONV_CONST
+#endif
+
+using namespace Strigi;
+using namespace std;
+
+namespace {
+
+const uint32_t blocksize = 65536;
+const int rounds = 20;
+
+vector<char>
+makeInput(const char* encoding, uint32_t size) {
+    vector<char> text(size);
+    bool utf16 = encoding[0] == 'U';
+    for (uint32_t i = 0; i < size; ++i) {
+        // mostly ascii with an occasional byte from the upper half
+        char c = (i % 61 == 60) ?'\n' :(char)('a' + rand() % 26);
+        if (rand() % 8 == 0) {
+            c = (char)(0xc0 + rand() % 0x3f);
+        }
+        if (utf16 && i % 2 == (encoding[6] == 'L')) {
+            c = 0;
+        }
+        text[i] = c;
+    }
+    return text;
+}
+
+double
+mbPerSecond(int64_t bytes, int64_t microseconds) {
+    return (microseconds) ?(double)bytes/microseconds :0;
+}
+
+int64_t
+timeSimple(const char* encoding, const vector<char>& in, vector<char>& out) {
+    SimpleTranscoder t;
+    if (!t.init(encoding)) {
+        return -1;
+    }
+    int64_t start = AnalyzerTimer::now(false);
+    for (int r = 0; r < rounds; ++r) {
+        t.reset();
+        for (uint32_t i = 0; i < in.size(); i += blocksize) {
+            if (t.convert(&in[i], blocksize, &out[0]) < 0) {
+                return -1;
+            }
+        }
+    }
+    return AnalyzerTimer::now(false) - start;
+}
+
+int64_t
+timeIconv(const char* encoding, const vector<char>& in, vector<char>& out) {
+    iconv_t cd = iconv_open("UTF-8", encoding);
+    if (cd == (iconv_t)-1) {
+        return -1;
+    }
+    int64_t start = AnalyzerTimer::now(false);
+    for (int r = 0; r < rounds; ++r) {
+        iconv(cd, 0, 0, 0, 0);
+        for (uint32_t i = 0; i < in.size(); i += blocksize) {
+            ICONV_CONST char* inp = (ICONV_CONST char*)&in[i];
+            size_t inleft = blocksize;
+            char* outp = &out[0];
+            size_t outleft = out.size();
+            if (iconv(cd, &inp, &inleft, &outp, &outleft) == (size_t)-1) {
+                iconv_close(cd);
+                return -1;
+            }
+        }
+    }
+    iconv_close(cd);
+    return AnalyzerTimer::now(false) - start;
+}
+
+}
+
+int
+main() {
+    const char* encodings[] = { "ISO-8859-1", "ISO-8859-15", "WINDOWS-1252",
+        "WINDOWS-1251", "UTF-16LE", "UTF-16BE", 0 };
+    const uint32_t size = 64*blocksize;
+    vector<char> out(3*blocksize + 4);
+    printf("%-14s %12s %12s\n", "encoding", "iconv MB/s", "table MB/s");
+    for (const char** e = encodings; *e; ++e) {
+        vector<char> in = makeInput(*e, size);
+        int64_t slow = timeIconv(*e, in, out);
+        int64_t fast = timeSimple(*e, in, out);
+        if (slow < 0 || fast < 0) {
+            printf("%-14s conversion failed\n", *e);
+            continue;
+        }
+        int64_t bytes = (int64_t)size*rounds;
+        printf("%-14s %12.1f %12.1f\n", *e, mbPerSecond(bytes, slow),
+            mbPerSecond(bytes, fast));
+    }
+    return 0;
+}
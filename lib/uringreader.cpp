@@ -0,0 +1,390 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "uringreader.h"
+#include <fcntl.h>
+#include <cerrno>
+#include <cstring>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+#ifndef O_CLOEXEC
+#define O_CLOEXEC 0
+#endif
+
+using namespace Strigi;
+using namespace std;
+
+class UringReader::Private {
+public:
+    const int depth;
+    // the reads go to this buffer; the data is not used, so the reads of
+    // one batch may overwrite each other
+    vector<char> scratch;
+    // the result of each request in the current batch
+    vector<int> results;
+#ifdef HAVE_IO_URING
+    int ringfd;
+    unsigned entries;
+    // set when the kernel does not support the operations that are used
+    bool broken;
+    void* sqring;
+    size_t sqringsize;
+    unsigned* sqhead;
+    unsigned* sqtail;
+    unsigned* sqmask;
+    unsigned* sqarray;
+    struct io_uring_sqe* sqes;
+    size_t sqessize;
+    void* cqring;
+    size_t cqringsize;
+    unsigned* cqhead;
+    unsigned* cqtail;
+    unsigned* cqmask;
+    struct io_uring_cqe* cqes;
+
+    void setup();
+    void close();
+    struct io_uring_sqe* sqe(unsigned i, uint8_t opcode, int fd,
+        const void* addr, uint32_t len);
+    bool submit(unsigned n);
+    unsigned reap();
+    void openBatch(Request* r, unsigned n);
+    void readBatch(Request* r, unsigned n);
+#endif
+
+    explicit Private(int d);
+    ~Private();
+    bool available() const;
+    void readSync(Request& r);
+};
+
+UringReader::Private::Private(int d) :depth((d > 0) ?d :1) {
+#ifdef HAVE_IO_URING
+    setup();
+#endif
+}
+UringReader::Private::~Private() {
+#ifdef HAVE_IO_URING
+    close();
+#endif
+}
+bool
+UringReader::Private::available() const {
+#ifdef HAVE_IO_URING
+    return ringfd != -1 && !broken;
+#else
+    return false;
+#endif
+}
+void
+UringReader::Private::readSync(Request& r) {
+    if (r.fd == -1) {
+        r.fd = ::open(r.path, O_RDONLY | O_CLOEXEC);
+    }
+    r.nread = -1;
+    if (r.fd != -1 && r.size > 0) {
+        if (scratch.size() < (size_t)r.size) {
+            scratch.resize(r.size);
+        }
+        r.nread = (int32_t)::read(r.fd, &scratch[0], r.size);
+        // leave the file at its start for the caller
+        lseek(r.fd, 0, SEEK_SET);
+    }
+}
+
+#ifdef HAVE_IO_URING
+void
+UringReader::Private::setup() {
+    sqring = cqring = sqes = 0;
+    broken = false;
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ringfd = (int)syscall(__NR_io_uring_setup, (unsigned)depth, &params);
+    if (ringfd < 0) {
+        // no kernel support or not allowed
+        ringfd = -1;
+        return;
+    }
+    entries = params.sq_entries;
+    sqringsize = params.sq_off.array + params.sq_entries*sizeof(unsigned);
+    cqringsize = params.cq_off.cqes
+        + params.cq_entries*sizeof(struct io_uring_cqe);
+    const bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single) {
+        // both rings are in one mapping
+        if (cqringsize > sqringsize) {
+            sqringsize = cqringsize;
+        }
+        cqringsize = sqringsize;
+    }
+    sqessize = params.sq_entries*sizeof(struct io_uring_sqe);
+    void* m = mmap(0, sqringsize, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ringfd, IORING_OFF_SQ_RING);
+    sqring = (m == MAP_FAILED) ?0 :m;
+    if (single) {
+        cqring = sqring;
+    } else if (sqring) {
+        m = mmap(0, cqringsize, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, ringfd, IORING_OFF_CQ_RING);
+        cqring = (m == MAP_FAILED) ?0 :m;
+    }
+    if (cqring) {
+        m = mmap(0, sqessize, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, ringfd, IORING_OFF_SQES);
+        sqes = (m == MAP_FAILED) ?0 :(struct io_uring_sqe*)m;
+    }
+    if (sqes == 0) {
+        close();
+        return;
+    }
+    char* sq = (char*)sqring;
+    sqhead = (unsigned*)(sq + params.sq_off.head);
+    sqtail = (unsigned*)(sq + params.sq_off.tail);
+    sqmask = (unsigned*)(sq + params.sq_off.ring_mask);
+    sqarray = (unsigned*)(sq + params.sq_off.array);
+    char* cq = (char*)cqring;
+    cqhead = (unsigned*)(cq + params.cq_off.head);
+    cqtail = (unsigned*)(cq + params.cq_off.tail);
+    cqmask = (unsigned*)(cq + params.cq_off.ring_mask);
+    cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+}
+void
+UringReader::Private::close() {
+    if (sqes) {
+        munmap(sqes, sqessize);
+    }
+    if (cqring && cqring != sqring) {
+        munmap(cqring, cqringsize);
+    }
+    if (sqring) {
+        munmap(sqring, sqringsize);
+    }
+    sqring = cqring = sqes = 0;
+    if (ringfd != -1) {
+        ::close(ringfd);
+        ringfd = -1;
+    }
+}
+struct io_uring_sqe*
+UringReader::Private::sqe(unsigned i, uint8_t opcode, int fd,
+        const void* addr, uint32_t len) {
+    struct io_uring_sqe* s = sqes + i;
+    memset(s, 0, sizeof(*s));
+    s->opcode = opcode;
+    s->fd = fd;
+    s->addr = (uint64_t)(uintptr_t)addr;
+    s->len = len;
+    s->user_data = i;
+    return s;
+}
+namespace {
+/**
+ * Give the kernel a moment before it is asked again.
+ **/
+void
+waitForKernel() {
+    struct timespec t;
+    t.tv_sec = 0;
+    t.tv_nsec = 1000000;
+    nanosleep(&t, 0);
+}
+}
+/**
+ * Store the results of the completed requests by index in results.
+ * @return the number of completions that were taken from the ring
+ **/
+unsigned
+UringReader::Private::reap() {
+    unsigned head = *cqhead;
+    unsigned end = __atomic_load_n(cqtail, __ATOMIC_ACQUIRE);
+    unsigned n = 0;
+    for (; head != end; ++head, ++n) {
+        const struct io_uring_cqe* c = cqes + (head & *cqmask);
+        results[(size_t)c->user_data] = c->res;
+    }
+    __atomic_store_n(cqhead, head, __ATOMIC_RELEASE);
+    return n;
+}
+/**
+ * Submit the first @p n submission entries and wait until all of them have
+ * completed. The results are stored by index in results.
+ *
+ * If the ring fails, the entries that the kernel has not taken yet are
+ * withdrawn and the function waits for the others, because they still use
+ * the paths of the requests and the scratch buffer. Their results are
+ * stored too, so that opened files are not lost.
+ **/
+bool
+UringReader::Private::submit(unsigned n) {
+    // the ring is empty between calls, so entry i can use slot i
+    const unsigned tail = *sqtail;
+    for (unsigned i = 0; i < n; ++i) {
+        sqarray[(tail + i) & *sqmask] = i;
+    }
+    __atomic_store_n(sqtail, tail + n, __ATOMIC_RELEASE);
+
+    unsigned done = 0;
+    while (done < n) {
+        unsigned submitted = __atomic_load_n(sqhead, __ATOMIC_ACQUIRE) - tail;
+        int r = (int)syscall(__NR_io_uring_enter, ringfd, n - submitted,
+            n - done, IORING_ENTER_GETEVENTS, 0, 0);
+        if (r < 0 && errno != EINTR) {
+            if (errno == EAGAIN || errno == EBUSY) {
+                // the kernel is short of resources or the completion queue
+                // is full: make room and try again
+                unsigned k = reap();
+                if (k == 0) {
+                    waitForKernel();
+                }
+                done += k;
+                continue;
+            }
+            // the ring cannot be used anymore
+            broken = true;
+            submitted = __atomic_load_n(sqhead, __ATOMIC_ACQUIRE) - tail;
+            __atomic_store_n(sqtail, tail + submitted, __ATOMIC_RELEASE);
+            while (done < submitted) {
+                unsigned k = reap();
+                if (k == 0 && syscall(__NR_io_uring_enter, ringfd, 0,
+                        submitted - done, IORING_ENTER_GETEVENTS, 0, 0) < 0) {
+                    waitForKernel();
+                }
+                done += k;
+            }
+            return false;
+        }
+        done += reap();
+    }
+    return true;
+}
+void
+UringReader::Private::openBatch(Request* r, unsigned n) {
+    for (unsigned i = 0; i < n; ++i) {
+        struct io_uring_sqe* s = sqe(i, IORING_OP_OPENAT, AT_FDCWD,
+            r[i].path, 0);
+        s->open_flags = O_RDONLY | O_CLOEXEC;
+    }
+    // also after a failure: the files that were opened are used or closed
+    // by the caller
+    submit(n);
+    for (unsigned i = 0; i < n; ++i) {
+        int res = results[i];
+        if (res >= 0) {
+            r[i].fd = res;
+        } else if (res == -EINVAL || res == -EOPNOTSUPP) {
+            // the kernel is too old for this operation
+            broken = true;
+        }
+    }
+}
+void
+UringReader::Private::readBatch(Request* r, unsigned n) {
+    int32_t max = 0;
+    for (unsigned i = 0; i < n; ++i) {
+        if (r[i].size > max) max = r[i].size;
+    }
+    if (max <= 0) {
+        return;
+    }
+    if (scratch.size() < (size_t)max) {
+        scratch.resize(max);
+    }
+    // index of each submitted read in r
+    vector<unsigned> which;
+    for (unsigned i = 0; i < n; ++i) {
+        if (r[i].fd != -1 && r[i].size > 0) {
+            struct io_uring_sqe* s = sqe((unsigned)which.size(),
+                IORING_OP_READ, r[i].fd, &scratch[0], r[i].size);
+            s->off = 0;
+            which.push_back(i);
+        }
+    }
+    if (which.empty() || !submit((unsigned)which.size())) {
+        return;
+    }
+    for (unsigned j = 0; j < which.size(); ++j) {
+        int res = results[j];
+        if (res >= 0) {
+            r[which[j]].nread = res;
+        } else if (res == -EINVAL || res == -EOPNOTSUPP) {
+            broken = true;
+        }
+    }
+}
+#endif
+
+UringReader::UringReader(int depth) :p(new Private(depth)) {
+}
+UringReader::~UringReader() {
+    delete p;
+}
+bool
+UringReader::available() const {
+    return p->available();
+}
+int
+UringReader::depth() const {
+    return p->depth;
+}
+void
+UringReader::read(vector<Request>& requests) {
+    for (size_t i = 0; i < requests.size(); ++i) {
+        requests[i].fd = -1;
+        requests[i].nread = -1;
+    }
+#ifdef HAVE_IO_URING
+    size_t start = 0;
+    while (start < requests.size() && p->available()) {
+        unsigned n = (unsigned)(requests.size() - start);
+        if (n > p->entries) {
+            n = p->entries;
+        }
+        p->results.assign(n, -ENOSYS);
+        p->openBatch(&requests[start], n);
+        if (p->available()) {
+            p->results.assign(n, -ENOSYS);
+            p->readBatch(&requests[start], n);
+        }
+        if (!p->available()) {
+            // finish this batch without the ring
+            break;
+        }
+        start += n;
+    }
+    for (size_t i = start; i < requests.size(); ++i) {
+        p->readSync(requests[i]);
+    }
+#else
+    for (size_t i = 0; i < requests.size(); ++i) {
+        p->readSync(requests[i]);
+    }
+#endif
+}
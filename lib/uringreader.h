@@ -0,0 +1,79 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef STRIGI_URINGREADER_H
+#define STRIGI_URINGREADER_H
+
+#include <strigi/strigiconfig.h>
+#include <vector>
+
+namespace Strigi {
+
+/**
+ * Opens files and reads their first bytes in batches with Linux io_uring.
+ *
+ * All files of a batch are opened with one system call and then all reads
+ * are submitted with another one, so a slow disk or network mount can work
+ * on the whole batch at once instead of on one file at a time. The data is
+ * only read to get it into the page cache; it is not returned.
+ *
+ * When the library was built without io_uring support or when the kernel
+ * does not allow io_uring, available() returns false and the caller has to
+ * open and read the files itself.
+ *
+ * A UringReader must only be used by one thread at a time.
+ **/
+class UringReader {
+public:
+    class Request {
+    public:
+        /** The path of the file to open. */
+        const char* path;
+        /** The number of bytes to read from the start of the file. */
+        int32_t size;
+        /** The opened file, which the caller must close, or -1. */
+        int fd;
+        /** The number of bytes that were read or -1. */
+        int32_t nread;
+
+        Request() :path(0), size(0), fd(-1), nread(-1) {}
+    };
+private:
+    class Private;
+    Private* p;
+public:
+    /**
+     * Set up a ring for @p depth requests at a time.
+     **/
+    explicit UringReader(int depth);
+    ~UringReader();
+    bool available() const;
+    /**
+     * The number of requests that are submitted together. read() splits
+     * larger batches.
+     **/
+    int depth() const;
+    /**
+     * Open the files in @p requests and read their first bytes. The fd and
+     * nread members of each request are filled in.
+     **/
+    void read(std::vector<Request>& requests);
+};
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#include "utf8validator.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRIGI_UTF8_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace Strigi;
+
+namespace {
+
+/**
+ * Return a pointer to the first byte that is not a printable ascii character
+ * or whitespace, i.e. the first byte that is a control character below 9 or
+ * that is not ascii.
+ **/
+const char*
+skipAscii(const char* p, const char* end) {
+#ifdef STRIGI_UTF8_SSE2
+    // bytes with the high bit set are negative, so one signed comparison
+    // finds both the control characters and the non-ascii bytes
+    const __m128i limit = _mm_set1_epi8(9);
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        if (_mm_movemask_epi8(_mm_cmplt_epi8(v, limit))) {
+            break;
+        }
+        p += 16;
+    }
+#else
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t high = 0x8080808080808080ULL;
+    while (end - p >= 8) {
+        uint64_t w;
+        memcpy(&w, p, 8);
+        // a high bit in w is a non-ascii byte, the second term sets the
+        // high bit of each byte that is smaller than 9
+        if ((w | ((w - 9*ones) & ~w)) & high) {
+            break;
+        }
+        p += 8;
+    }
+#endif
+    while (p < end && (signed char)*p > 8) {
+        p++;
+    }
+    return p;
+}
+
+}
+
+const char*
+Strigi::validateUtf8(const char* p, int32_t length, char& nb) {
+    const char* end = p + length;
+    const char* cs = p;
+    nb = 0;
+    while (p < end) {
+        if (nb == 0) {
+            p = skipAscii(p, end);
+            if (p == end) {
+                break;
+            }
+        }
+        unsigned char c = (unsigned char)*p;
+        if (nb) {
+            if ((0xC0 & c) != 0x80) {
+                nb = 0;
+                return p;
+            }
+            nb--;
+        } else if ((0xE0 & c) == 0xC0) {
+            cs = p;
+            nb = 1;
+        } else if ((0xF0 & c) == 0xE0) {
+            cs = p;
+            nb = 2;
+        } else if ((0xF8 & c) == 0xF0) {
+            cs = p;
+            nb = 3;
+        } else {
+            // not ascii or a control character
+            return p;
+        }
+        p++;
+    }
+    if (nb) {
+        return cs;
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+/* This file is part of Strigi Desktop Search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef STRIGI_UTF8VALIDATOR_H
+#define STRIGI_UTF8VALIDATOR_H
+
+#include <strigi/strigiconfig.h>
+#include <string>
+
+namespace Strigi {
+
+/**
+ * Check that @p p contains utf8 text. This gives the same answers as
+ * checkUtf8() from libstreams but skips runs of ascii 16 or 8 bytes at a
+ * time, which is what almost all text consists of.
+ *
+ * @return 0 if the text is valid, a pointer to the start of an incomplete
+ *         character at the end of the text, in which case @p nb is the
+ *         number of missing bytes, or a pointer to the first invalid byte,
+ *         in which case @p nb is 0
+ **/
+const char* validateUtf8(const char* p, int32_t length, char& nb);
+
+inline bool
+validateUtf8(const char* p, int32_t length) {
+    char nb;
+    return validateUtf8(p, length, nb) == 0;
+}
+inline bool
+validateUtf8(const std::string& s) {
+    return validateUtf8(s.c_str(), (int32_t)s.length());
+}
+
+}
+
+#endif
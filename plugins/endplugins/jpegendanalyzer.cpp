@@ -201,6 +201,7 @@ map<string, const RegisteredField*>::const_iterator i = exifFields.begin();
     addField(jpegProcessField);
     addField(thumbnailField);
     addField(typeField);
+    addSignature("\xff\xd8\xff", 3);
 }
 
 bool
@@ -48,6 +48,11 @@ class DigestEventAnalyzerFactory
         : public Strigi::StreamEventAnalyzerFactory {
 public:
     const Strigi::RegisteredField* shafield;
+    uint32_t typeSymbol;
+    uint32_t fileHashSymbol;
+    uint32_t hashAlgorithmSymbol;
+    uint32_t sha1Symbol;
+    uint32_t hashValueSymbol;
 private:
     const char* name() const {
         return "DigestEventAnalyzer";
@@ -99,9 +104,11 @@ DigestEventAnalyzer::endAnalysis(bool complete) {
     hash.assign(d);
     const string hashUri = analysisresult->newAnonymousUri();
     analysisresult->addValue(factory->shafield, hashUri);
-    analysisresult->addTriplet(hashUri, type, nfoFileHash);
-    analysisresult->addTriplet(hashUri, nfohashAlgorithm, SHA1);
-    analysisresult->addTriplet(hashUri, hashValue, hash);
+    analysisresult->addTriplet(hashUri, factory->typeSymbol,
+        factory->fileHashSymbol);
+    analysisresult->addTriplet(hashUri, factory->hashAlgorithmSymbol,
+        factory->sha1Symbol);
+    analysisresult->addTriplet(hashUri, factory->hashValueSymbol, hash);
     analysisresult = 0;
 }
 bool
@@ -113,6 +120,11 @@ DigestEventAnalyzerFactory::registerFields(FieldRegister& reg) {
     shafield = reg.registerField(
         "http://www.semanticdesktop.org/ontologies/2007/03/22/nfo#hasHash");
     addField(shafield);
+    typeSymbol = reg.registerSymbol(type);
+    fileHashSymbol = reg.registerSymbol(nfoFileHash);
+    hashAlgorithmSymbol = reg.registerSymbol(nfohashAlgorithm);
+    sha1Symbol = reg.registerSymbol(SHA1);
+    hashValueSymbol = reg.registerSymbol(hashValue);
 }
 // Analyzer
 
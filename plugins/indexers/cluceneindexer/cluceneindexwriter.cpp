@@ -19,6 +19,7 @@
  */
 
 #include "cluceneindexwriter.h"
+#include <strigi/documentrecord.h>
 #include "tcharutils.h"
 #include <CLucene.h>
 #include <CLucene/store/Lock.h>
@@ -28,6 +29,7 @@
 #include <CLucene/search/PrefixQuery.h>
 #include <sstream>
 #include <assert.h>
+#include <stdio.h>
 
 #ifdef STRIGI_USE_CLUCENE_COMPRESSEDFIELDS
 #include "jsgzipcompressstream.h"
@@ -183,6 +185,55 @@ CLuceneIndexWriter::addValue(const Strigi::AnalysisResult* idx,
     addValue(idx, field, o.str());
 }
 void
+CLuceneIndexWriter::addValues(const Strigi::AnalysisResult* idx,
+        const DocumentRecord& record) {
+    // the key of the previous field is kept because the values of a field
+    // are often added one after the other
+    const RegisteredField* lastfield = 0;
+    AnalyzerConfiguration::FieldType type = AnalyzerConfiguration::None;
+#if defined(_UCS2)
+    wstring key;
+#endif
+    string value;
+    char buf[32];
+    for (uint32_t i = 0; i < record.size(); ++i) {
+        const DocumentRecord::Entry& e = record.entry(i);
+        if (e.field != lastfield) {
+            lastfield = e.field;
+            type = idx->config().indexType(e.field);
+#if defined(_UCS2)
+            if (type != AnalyzerConfiguration::None) {
+                key = utf8toucs2(e.field->key());
+            }
+#endif
+        }
+        if (type == AnalyzerConfiguration::None) continue;
+        switch (e.type) {
+        case DocumentRecord::String:
+            value.assign(record.data(e), e.size);
+            break;
+        case DocumentRecord::Int32:
+            sprintf(buf, "%d", (int)record.int32Value(e));
+            value.assign(buf);
+            break;
+        case DocumentRecord::UInt32:
+            sprintf(buf, "%u", (unsigned int)record.uint32Value(e));
+            value.assign(buf);
+            break;
+        case DocumentRecord::Double:
+            // the same format as writing the double to an ostream
+            sprintf(buf, "%g", record.doubleValue(e));
+            value.assign(buf);
+            break;
+        }
+#if defined(_UCS2)
+        addValue(idx, type, key.c_str(), value);
+#else
+        addValue(idx, type, e.field->key(), value);
+#endif
+    }
+}
+void
 CLuceneIndexWriter::startAnalysis(const AnalysisResult* idx) {
     doccount++;
     CLuceneDocData*doc = new CLuceneDocData();
@@ -194,14 +245,18 @@ CLuceneIndexWriter::startAnalysis(const AnalysisResult* idx) {
 void
 CLuceneIndexWriter::finishAnalysis(const AnalysisResult* idx) {
     CLuceneDocData* doc = static_cast<CLuceneDocData*>(idx->writerData());
-    wstring c(utf8toucs2(doc->content));
     jstreams::StringReader<char>* sr = NULL; //we use this for compressed streams
 
     if (doc->content.length() > 0) {
         const TCHAR* mappedFn = mapId(_T(""));
 #if defined(_UCS2)
+        // the field copies the text, so the utf8 and the wide copy are
+        // released as soon as possible to keep the peak memory use down
+        wstring c(utf8toucs2(doc->content));
     #ifndef STRIGI_USE_CLUCENE_COMPRESSEDFIELDS
+        string().swap(doc->content);
         doc->doc.add(*new Field(mappedFn, c.c_str(), Field::STORE_YES | Field::INDEX_TOKENIZED));
+        wstring().swap(c);
     #else
         // lets store the content as utf8. remember, the stream is required
         // until the document is added, so a static construction of stringreader
@@ -56,9 +56,16 @@ protected:
         const Strigi::RegisteredField* fieldname, double value);
     void addTriplet(const std::string& subject,
         const std::string& predicate, const std::string& object) {}
+    void addTriplet(const Strigi::AnalysisResult*, const std::string&,
+        uint32_t, const std::string&) {}
+    void addTriplet(const Strigi::AnalysisResult*, const std::string&,
+        uint32_t, uint32_t) {}
     void addValue(const Strigi::AnalysisResult*,
         const Strigi::RegisteredField* field, const std::string& name,
         const std::string& value) {}
+    bool acceptsDocumentRecords() const { return true; }
+    void addValues(const Strigi::AnalysisResult* idx,
+        const Strigi::DocumentRecord& record);
     void initWriterData(const Strigi::FieldRegister& f);
     void releaseWriterData(const Strigi::FieldRegister& f);
 public:
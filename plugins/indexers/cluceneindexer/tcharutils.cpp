@@ -28,11 +28,22 @@ std::wstring
 utf8toucs2(const char*p, const char*e) {
     wstring ucs2;
     if (e <= p) return ucs2;
-    ucs2.reserve(3*(e-p));
+    // utf8 never has fewer bytes than characters
+    ucs2.reserve(e-p);
     wchar_t w = 0;
     char nb = 0;
     while (p < e) {
         char c = *p;
+        if (nb == 0 && (c & 0x80) == 0) {
+            // copy a run of ascii characters in one go
+            const char* s = p;
+            do {
+                ++p;
+            } while (p < e && (*p & 0x80) == 0);
+            ucs2.append(s, p);
+            w = 0;
+            continue;
+        }
         if (nb--) {
             w = (w<<6) + (c & 0x3f);
         } else if ((0xE0 & c) == 0xC0) {
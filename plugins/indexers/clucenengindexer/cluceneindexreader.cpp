@@ -840,6 +840,55 @@ CLuceneIndexReader::getChildren(const std::string& parent,
     searcher.close();
     _CLDELETE(q);
 }
+bool
+CLuceneIndexReader::listFiles(FileHandler& handler) {
+    lucene::index::IndexReader* reader = manager->checkReader(true);
+    if (reader == NULL) {
+        return false;
+    }
+    // read the mtime of all documents in the order in which they are
+    // stored, which is much faster than loading them in the order of
+    // their paths
+    const TCHAR* mtime = mapId(Private::mtime());
+    const int32_t max = reader->maxDoc();
+    vector<time_t> mtimes(max, (time_t)-1);
+    lucene::document::MapFieldSelector fieldSelector;
+    fieldSelector.add(mtime);
+    Document d;
+    for (int32_t i = 0; i < max; ++i) {
+        if (!reader->isDeleted(i) && reader->document(i, d, &fieldSelector)) {
+            const TCHAR* v = d.get(mtime);
+            // check that mtime is defined for this document
+            if (v) {
+                mtimes[i] = atoi(wchartoutf8(v).c_str());
+            }
+        }
+        d.clear();
+    }
+
+    // the terms of a field are sorted, so the paths come in order
+    Term* first = _CLNEW Term(mapId(Private::systemlocation()), L"");
+    TermEnum* terms = reader->terms(first);
+    TermDocs* docs = reader->termDocs();
+    bool more = true;
+    do {
+        Term* t = terms->term(false);
+        if (t == 0 || wcscmp(t->field(), first->field()) != 0) {
+            break;
+        }
+        docs->seek(t);
+        if (docs->next() && mtimes[docs->doc()] != (time_t)-1) {
+            more = handler.handleFile(wchartoutf8(t->text()),
+                mtimes[docs->doc()]);
+        }
+    } while (more && terms->next());
+    docs->close();
+    _CLDELETE(docs);
+    terms->close();
+    _CLDELETE(terms);
+    _CLDECDELETE(first);
+    return true;
+}
 vector<IndexedDocument>
 CLuceneIndexReader::Private::strigiSpecial(const string& command) {
     vector<IndexedDocument> r;
@@ -69,6 +69,7 @@ public:
         uint32_t max, uint32_t offset);
     void getChildren(const std::string& parent,
             std::map<std::string, time_t>& );
+    bool listFiles(FileHandler& handler);
 
     // implementation function
     void getDocuments(const std::vector<std::string>& fields,
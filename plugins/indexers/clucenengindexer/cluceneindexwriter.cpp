@@ -175,13 +175,17 @@ CLuceneIndexWriter::startAnalysis(const AnalysisResult* idx) {
 void
 CLuceneIndexWriter::finishAnalysis(const AnalysisResult* idx) {
     CLuceneDocData* doc = static_cast<CLuceneDocData*>(idx->writerData());
-    wstring c(utf8toucs2(doc->content));
 
     if (doc->content.length() > 0) {
       const TCHAR* mappedFn = mapId(_T(""));
+      // the field copies the text, so the utf8 and the wide copy are
+      // released as soon as possible to keep the peak memory use down
+      wstring c(utf8toucs2(doc->content));
+      string().swap(doc->content);
 
       // add the stored field as compressed and indexed
       doc->doc.add(*new Field(mappedFn, c.c_str(), Field::STORE_YES | Field::STORE_COMPRESS | Field::INDEX_TOKENIZED));
+      wstring().swap(c);
     }
     lucene::index::IndexWriter* writer = manager->refWriter();
     if (writer) {
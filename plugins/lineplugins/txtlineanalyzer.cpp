@@ -22,6 +22,7 @@
 #include <strigi/strigiconfig.h>
 #include <strigi/analysisresult.h>
 #include <strigi/fieldtypes.h>
+#include <cctype>
 
 using namespace std;
 using namespace Strigi;
@@ -64,35 +65,46 @@ TxtLineAnalyzer::startAnalysis(AnalysisResult* i) {
 }
 void
 TxtLineAnalyzer::handleLine(const char* data, uint32_t length) {
-    bool inWord = false;
-
-    totalLines++;
-    totalCharacters += length;
-
-    if (maxLineLength < length)
-        maxLineLength = length;
+    LineView l;
+    l.data = data;
+    l.length = length;
+    handleLines(&l, 1);
+}
+void
+TxtLineAnalyzer::handleLines(const LineView* lines, uint32_t n) {
+    // count in local variables and store the totals once per block
+    int words = 0;
+    int characters = 0;
+    uint32_t maxLength = maxLineLength;
 
-    // instead of using regexp use this elementary solution
-    for (unsigned int i = 0; i < length; i++) {
-        bool spacer = true;
-        if (isspace(data[i]) == 0)
-            spacer = false;
+    for (uint32_t l = 0; l < n; ++l) {
+        const char* data = lines[l].data;
+        const uint32_t length = lines[l].length;
+        characters += length;
+        if (maxLength < length)
+            maxLength = length;
 
-        if (!spacer && !inWord) {// beginning of a word
-            totalWords++;
-            inWord = true;
+        // instead of using regexp use this elementary solution
+        bool inWord = false;
+        for (uint32_t i = 0; i < length; i++) {
+            bool spacer = isspace((unsigned char)data[i]) != 0;
+            if (!spacer && !inWord) // beginning of a word
+                words++;
+            inWord = !spacer;
         }
-        //else if (!spacer && inWord) {/*inside word, do nothing*/}
-        else if (spacer && inWord)
-            inWord = false;
-    }
 
-    //TODO: by now it isn't possible to detect mac formatting
-    //endline should be just '\r'. I don't know if it is still true with latest
-    // versions of OSX, I have tried with tiger and I got a standard unix file.
-    if (length > 0 && data[length-1] == '\r')
-        dos = true;
+        //TODO: by now it isn't possible to detect mac formatting
+        //endline should be just '\r'. I don't know if it is still true with
+        // latest versions of OSX, I have tried with tiger and I got a
+        // standard unix file.
+        if (length > 0 && data[length-1] == '\r')
+            dos = true;
+    }
 
+    totalLines += n;
+    totalWords += words;
+    totalCharacters += characters;
+    maxLineLength = maxLength;
 }
 void
 TxtLineAnalyzer::endAnalysis(bool complete) {
@@ -45,6 +45,7 @@ public:
     const char* name() const { return "TxtLineAnalyzer"; }
     void startAnalysis(Strigi::AnalysisResult*);
     void handleLine(const char* data, uint32_t length);
+    void handleLines(const Strigi::LineView* lines, uint32_t n);
     void endAnalysis(bool complete);
     bool isReadyWithStream();
 };
@@ -33,6 +33,13 @@
     #define STRIGI_MUTEX_TRY_LOCK(x) pthread_mutex_trylock(x)
     #define STRIGI_MUTEX_UNLOCK(x) pthread_mutex_unlock(x)
 
+    #define STRIGI_COND_DEFINE(x) pthread_cond_t x
+    #define STRIGI_COND_INIT(x) pthread_cond_init(x, 0)
+    #define STRIGI_COND_DESTROY(x) pthread_cond_destroy(x)
+    #define STRIGI_COND_WAIT(x, mutex) pthread_cond_wait(x, mutex)
+    #define STRIGI_COND_SIGNAL(x) pthread_cond_signal(x)
+    #define STRIGI_COND_BROADCAST(x) pthread_cond_broadcast(x)
+
     #define STRIGI_THREAD_DEFINE(x) pthread_t x
     #define STRIGI_THREAD_TYPE pthread_t
     #define STRIGI_THREAD_CREATE(threadObject, function, data) pthread_create(threadObject, NULL, function, data)
@@ -49,6 +56,13 @@
     #define STRIGI_MUTEX_TRY_LOCK(x) TryEnterCriticalSection(x)
     #define STRIGI_MUTEX_UNLOCK(x) LeaveCriticalSection(x)
 
+    #define STRIGI_COND_DEFINE(x) CONDITION_VARIABLE x
+    #define STRIGI_COND_INIT(x) InitializeConditionVariable(x)
+    #define STRIGI_COND_DESTROY(x)
+    #define STRIGI_COND_WAIT(x, mutex) SleepConditionVariableCS(x, mutex, INFINITE)
+    #define STRIGI_COND_SIGNAL(x) WakeConditionVariable(x)
+    #define STRIGI_COND_BROADCAST(x) WakeAllConditionVariable(x)
+
     #define STRIGI_THREAD_DEFINE(x) HANDLE x
     #define STRIGI_THREAD_TYPE HANDLE
     #define STRIGI_THREAD_CREATE(threadObject, rfunction, data) ((*(threadObject)=CreateThread( NULL, 0, (LPTHREAD_START_ROUTINE)rfunction,  data, 0, NULL))==NULL?-1:0)